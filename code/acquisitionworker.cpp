@@ -0,0 +1,172 @@
+#include "acquisitionworker.h"
+
+#ifdef __linux__
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+
+AcquisitionWorker::AcquisitionWorker(Neureset* neureset, const int period) :
+        neureset(neureset), running(false), period(std::max(1, period)), core(ACQUISITION_ANY_CORE),
+        priority(ACQUISITION_NORMAL_PRIORITY), reconfigure(false), pinned(false), realtime(false),
+        frames(0), overruns(0) {}
+
+AcquisitionWorker::~AcquisitionWorker() {
+    stop();
+}
+
+
+/*
+    Spawns the worker, no effect when already running.
+*/
+void AcquisitionWorker::start() {
+    if (running.exchange(true))
+        return;
+
+    neureset->setRefreshPeriod(period);
+    reconfigure = true;
+    thread = std::thread(&AcquisitionWorker::run, this);
+}
+
+/*
+    Wakes the worker and joins it, the frame in progress is finished first.
+*/
+void AcquisitionWorker::stop() {
+    {
+        std::lock_guard<std::mutex> lock(wake);
+        running = false;
+    }
+    wakeup.notify_all();
+
+    if (thread.joinable())
+        thread.join();
+}
+
+bool AcquisitionWorker::isRunning() const {
+    return running;
+}
+
+
+/*
+    One frame per tick until stopped.
+*/
+void AcquisitionWorker::run() {
+    std::chrono::steady_clock::time_point next = std::chrono::steady_clock::now();
+
+    while (running) {
+        if (reconfigure.exchange(false))
+            configure();
+
+        std::mutex& mtx = neureset->getMutex();
+        mtx.lock();
+        neureset->generator();
+        mtx.unlock();
+        ++frames;
+
+        const std::chrono::milliseconds step(period.load());
+        const std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+
+        next += step;
+        if (now > next) {
+            // late, skip the missed ticks rather than run them back to back
+            overruns += 1 + (now - next) / step;
+            next = now + step;
+        }
+
+        std::unique_lock<std::mutex> lock(wake);
+        wakeup.wait_until(lock, next, [this]() { return !running; });
+    }
+}
+
+
+/*
+    Applies affinity and priority to the calling (worker) thread.
+*/
+void AcquisitionWorker::configure() {
+#ifdef __linux__
+    const pthread_t self = pthread_self();
+
+    cpu_set_t set;
+    CPU_ZERO(&set);
+
+    const int target = core;
+    const int cores = std::max(1, static_cast<int>(std::thread::hardware_concurrency()));
+    if (target >= 0 && target < cores && target < CPU_SETSIZE) {
+        CPU_SET(target, &set);
+    } else {
+        for (int c = 0; c < cores && c < CPU_SETSIZE; ++c)
+            CPU_SET(c, &set);
+    }
+
+    const bool pin = target >= 0 && target < cores;
+    if (pthread_setaffinity_np(self, sizeof(set), &set) == 0) {
+        pinned = pin;
+    } else {
+        pinned = false;
+        std::cout << "Acquisition: could not pin to core " << target << std::endl;
+    }
+
+    const int level = priority;
+    sched_param param{};
+    int policy = SCHED_OTHER;
+    if (level > ACQUISITION_NORMAL_PRIORITY) {
+        policy = SCHED_FIFO;
+        param.sched_priority = std::min(std::max(level, sched_get_priority_min(SCHED_FIFO)),
+                                        sched_get_priority_max(SCHED_FIFO));
+    }
+
+    if (pthread_setschedparam(self, policy, &param) == 0) {
+        realtime = policy == SCHED_FIFO;
+    } else {
+        realtime = false;
+        std::cout << "Acquisition: could not set priority " << level << std::endl;
+    }
+#else
+    if (core != ACQUISITION_ANY_CORE || priority != ACQUISITION_NORMAL_PRIORITY)
+        std::cout << "Acquisition: affinity and priority need Linux" << std::endl;
+#endif
+}
+
+
+/*
+    ms between frames, also sets how much signal each streaming refresh appends.
+    Takes effect from the next tick.
+*/
+void AcquisitionWorker::setPeriod(const int period) {
+    this->period = std::max(1, period);
+    neureset->setRefreshPeriod(this->period);
+}
+
+int AcquisitionWorker::getPeriod() const {
+    return period;
+}
+
+void AcquisitionWorker::setAffinity(const int core) {
+    this->core = core;
+    reconfigure = true;
+}
+
+void AcquisitionWorker::setPriority(const int priority) {
+    this->priority = priority;
+    reconfigure = true;
+}
+
+// pinned to a core
+bool AcquisitionWorker::isPinned() const {
+    return pinned;
+}
+
+// SCHED_FIFO granted
+bool AcquisitionWorker::isRealtime() const {
+    return realtime;
+}
+
+// frames produced since construction
+long long AcquisitionWorker::getFrames() const {
+    return frames;
+}
+
+// ticks dropped because a frame ran late
+long long AcquisitionWorker::getOverruns() const {
+    return overruns;
+}
@@ -0,0 +1,80 @@
+#ifndef ACQUISITIONWORKER_H
+#define ACQUISITIONWORKER_H
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <iostream>
+#include <mutex>
+#include <thread>
+
+#include "defs.h"
+#include "neureset.h"
+
+// no pinning / normal time sharing scheduling
+#define ACQUISITION_ANY_CORE -1
+#define ACQUISITION_NORMAL_PRIORITY 0
+
+
+/*
+    Drives Neureset::generator() from its own thread at a fixed cadence, apart from the GUI.
+
+    Each tick synthesizes (or takes the pushed samples), filters and analyzes one frame under the
+    device mutex, and the frame is published through Neureset's snapshot buffer. The UI only draws
+    the newest snapshot, so analysis never runs on the GUI thread and repaint never holds up
+    acquisition.
+
+    Ticks are scheduled on absolute deadlines from steady_clock, so the cadence does not drift
+    with the time spent per frame. A frame that overruns its deadline drops the missed ticks
+    instead of bursting to catch up, and is counted in getOverruns.
+
+    Optional real time setup (Linux), applied by the worker to itself, also while running:
+        setAffinity     pin to one core, ACQUISITION_ANY_CORE to release
+        setPriority     SCHED_FIFO at priority (1 - 99), ACQUISITION_NORMAL_PRIORITY for SCHED_OTHER
+    Both need the matching privileges (CAP_SYS_NICE for priority), a refusal is reported and the
+    thread keeps running unpinned / at normal priority.
+*/
+class AcquisitionWorker {
+    private:
+        Neureset* const neureset;
+
+        std::thread thread;
+        std::atomic<bool> running;
+
+        std::mutex wake;                // sleeping between ticks, stop cuts the wait short
+        std::condition_variable wakeup;
+
+        std::atomic<int> period;        // ms
+        std::atomic<int> core;
+        std::atomic<int> priority;
+        std::atomic<bool> reconfigure;  // affinity / priority changed, applied on the next tick
+
+        std::atomic<bool> pinned;
+        std::atomic<bool> realtime;
+
+        std::atomic<long long> frames;
+        std::atomic<long long> overruns;
+
+        void run();
+        void configure();
+
+    public:
+        explicit AcquisitionWorker(Neureset* neureset, const int period = REFRESH_PERIOD);
+        ~AcquisitionWorker();
+
+        void start();
+        void stop();
+        bool isRunning() const;
+
+        void setPeriod(const int period);
+        int getPeriod() const;
+
+        void setAffinity(const int core);
+        void setPriority(const int priority);
+        bool isPinned() const;
+        bool isRealtime() const;
+
+        long long getFrames() const;
+        long long getOverruns() const;
+};
+#endif
@@ -6,18 +6,17 @@
 
 #include "defs.h"
 #include "neureset.h"
+#include "wavesynth.h"
 
 class Agent {
     private:
         Neureset* neureset;
-        double* const* const brainWave;
+        Matrix<double> brainWave;
 
-        double** buildBrainWave();
-        double* linspace(const int start, const int end, const int numPoints);
+        static Matrix<double> buildBrainWave();
 
     public:
         explicit Agent(Neureset* neureset);
-        ~Agent();
 
         void helmet();
 };
@@ -0,0 +1,66 @@
+#include "bandpowers.h"
+
+namespace {
+    const double centers[NUM_BRAIN_FREQ] = BAND_CENTERS;
+    const double offsets[NUM_BRAIN_FREQ] = BAND_OFFSETS;
+    const char* const names[NUM_BRAIN_FREQ] = {"delta", "theta", "alpha", "beta"};
+}
+
+
+BandPowers::BandPowers(const int sites, const int bins, const double* freqs) :
+        sites(sites), bins(bins), freqs(new double[bins]), bandOf(new int[bins]),
+        stats(new BandStats[sites * NUM_BRAIN_FREQ]()) {
+
+    // half open [low, high), the top band keeps its upper edge
+    for (int k = 0; k < bins; ++k) {
+        this->freqs[k] = freqs[k];
+        bandOf[k] = -1;
+
+        for (int b = 0; b < NUM_BRAIN_FREQ; ++b)
+            if (freqs[k] >= getLow(b) && (freqs[k] < getHigh(b) || (b == NUM_BRAIN_FREQ - 1 && freqs[k] == getHigh(b)))) {
+                bandOf[k] = b;
+                break;
+            }
+    }
+}
+
+BandPowers::~BandPowers() {
+    delete[] freqs;
+    delete[] bandOf;
+    delete[] stats;
+}
+
+
+/*
+    Clears a site before its next spectrum.
+*/
+void BandPowers::begin(const int site) {
+    if (site < 0 || site >= sites)
+        return;
+
+    for (int b = 0; b < NUM_BRAIN_FREQ; ++b)
+        stats[site * NUM_BRAIN_FREQ + b] = BandStats{0., 0., 0.};
+}
+
+
+// NUM_BRAIN_FREQ bands of the last spectrum of site
+const BandStats* BandPowers::get(const int site) const {
+    return stats + site * NUM_BRAIN_FREQ;
+}
+
+// band of bin k, -1 if none
+int BandPowers::getBand(const int k) const {
+    return bandOf[k];
+}
+
+double BandPowers::getLow(const int band) {
+    return centers[band] - offsets[band];
+}
+
+double BandPowers::getHigh(const int band) {
+    return centers[band] + offsets[band];
+}
+
+const char* BandPowers::getName(const int band) {
+    return names[band];
+}
@@ -0,0 +1,65 @@
+#ifndef BANDPOWERS_H
+#define BANDPOWERS_H
+
+#include "defs.h"
+
+
+// one band of one site
+struct BandStats {
+    double power;    // sum of bin powers, uv^2
+    double peakFreq; // strongest bin, hz
+    double peakAmp;  // its magnitude, uv
+};
+
+
+/*
+    Delta, theta, alpha and beta power per site.
+
+    Bands span BAND_CENTERS +- BAND_OFFSETS, the same ranges Agent synthesizes. Bins are mapped
+    to bands once, stats are accumulated bin by bin inside the spectrum pass that already
+    computes magnitudes, so the bands cost no extra scan.
+
+    Usage per spectrum: begin(site), accumulate(site, k, ...) for every bin.
+*/
+class BandPowers {
+    private:
+        const int sites;
+        const int bins;
+
+        double* const freqs;      // bin centre, hz
+        int* const bandOf;        // band of each bin, -1 outside all bands
+        BandStats* const stats;   // sites x NUM_BRAIN_FREQ
+
+    public:
+        BandPowers(const int sites, const int bins, const double* freqs);
+        ~BandPowers();
+
+        void begin(const int site);
+        void accumulate(const int site, const int k, const double power, const double magnitude);
+
+        const BandStats* get(const int site) const;
+        int getBand(const int k) const;
+
+        static double getLow(const int band);
+        static double getHigh(const int band);
+        static const char* getName(const int band);
+};
+
+
+/*
+    Folds bin k into its band. Inline, called once per bin from the spectrum loop.
+*/
+inline void BandPowers::accumulate(const int site, const int k, const double power, const double magnitude) {
+    const int band = bandOf[k];
+    if (band < 0 || site < 0 || site >= sites)
+        return;
+
+    BandStats& entry = stats[site * NUM_BRAIN_FREQ + band];
+    entry.power += power;
+
+    if (magnitude > entry.peakAmp) {
+        entry.peakAmp = magnitude;
+        entry.peakFreq = freqs[k];
+    }
+}
+#endif
@@ -0,0 +1,117 @@
+#include "chirpz.h"
+
+
+template <typename T>
+ChirpZ<T>::ChirpZ(const int size, const int rate, const double low, const double high, const int points) :
+        size(size), points(points), low(low), high(high),
+        fft(fastLength(size + points - 1)),
+        pre(size), post(points), filter(fft.getLength()), work(fft.getLength()), spectrum(fft.getLength()) {
+
+    const int length = fft.getLength();
+    const double step = (high - low) / points;
+
+    // chirp phase pi step m^2 / rate, m^2 reduced before scaling to keep double precision
+    auto chirp = [step, rate](const long long m) {
+        const double angle = PI * step * static_cast<double>(m * m) / rate;
+        return std::polar(1., angle);
+    };
+
+    for (int n = 0; n < size; ++n) {
+        const double shift = -2. * PI * low * n / rate;
+        pre[n] = std::complex<T>(std::polar(1., shift) * std::conj(chirp(n)));
+    }
+
+    for (int k = 0; k < points; ++k)
+        post[k] = std::complex<T>(std::conj(chirp(k)));
+
+    // circular chirp, lags 0 .. points - 1 then -(size - 1) .. -1 wrapped to the end
+    for (int m = 0; m < length; ++m)
+        work[m] = std::complex<T>(0);
+    for (int m = 0; m < points; ++m)
+        work[m] = std::complex<T>(chirp(m));
+    for (int m = 1; m < size; ++m)
+        work[length - m] = std::complex<T>(chirp(m));
+
+    fft.forward(work.data(), filter.data());
+
+    for (int m = 0; m < length; ++m)
+        filter[m] /= static_cast<T>(length);
+}
+
+
+/*
+    Smallest 2^a 3^b at least minimum, both radices have dedicated butterflies.
+*/
+template <typename T>
+int ChirpZ<T>::fastLength(const int minimum) {
+    int best = 1;
+    while (best < minimum)
+        best *= 2;
+
+    for (int three = 1; three < best; three *= 3) {
+        int candidate = three;
+        while (candidate < minimum)
+            candidate *= 2;
+        best = std::min(best, candidate);
+    }
+
+    return best;
+}
+
+
+/*
+    Premultiply, convolve with the chirp through the FFT, postmultiply.
+*/
+template <typename T>
+void ChirpZ<T>::transform(const T* in, T* re, T* im) {
+    const int length = fft.getLength();
+
+    for (int n = 0; n < size; ++n)
+        work[n] = pre[n] * in[n];
+    for (int n = size; n < length; ++n)
+        work[n] = std::complex<T>(0);
+
+    fft.forward(work.data(), spectrum.data());
+
+    for (int m = 0; m < length; ++m)
+        spectrum[m] *= filter[m];
+
+    fft.inverse(spectrum.data(), work.data());
+
+    for (int k = 0; k < points; ++k) {
+        const std::complex<T> value = post[k] * work[k];
+        re[k] = value.real();
+        im[k] = value.imag();
+    }
+}
+
+
+template <typename T>
+int ChirpZ<T>::getSize() const {
+    return size;
+}
+
+template <typename T>
+int ChirpZ<T>::getPoints() const {
+    return points;
+}
+
+template <typename T>
+double ChirpZ<T>::getLow() const {
+    return low;
+}
+
+template <typename T>
+double ChirpZ<T>::getHigh() const {
+    return high;
+}
+
+// transform length of the convolution
+template <typename T>
+int ChirpZ<T>::getLength() const {
+    return fft.getLength();
+}
+
+
+template class ChirpZ<float>;
+template class ChirpZ<double>;
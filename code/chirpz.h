@@ -0,0 +1,53 @@
+#ifndef CHIRPZ_H
+#define CHIRPZ_H
+
+#include <algorithm>
+#include <complex>
+#include <vector>
+
+#include "defs.h"
+#include "fft.h"
+
+
+/*
+    Chirp-z (Bluestein) transform over a frequency span.
+
+    size real samples at rate hz, points frequencies evenly spaced over [low, high):
+        X[k] = sum x[n] e^(-2 pi i f_k n / rate), f_k = low + k (high - low) / points
+
+    Resolution is set by points, not by the window, and only the span is computed. The sum is
+    rewritten as a convolution with a chirp using nk = (n^2 + k^2 - (k - n)^2) / 2, one forward
+    and one inverse FFT of length >= size + points - 1. O(L log L) with the chirp spectrum kept.
+
+    Unscaled like SpectralEngine. Instantiated for float and double.
+*/
+template <typename T>
+class ChirpZ {
+    private:
+        const int size;
+        const int points;
+        const double low;
+        const double high;
+
+        ComplexFFT<T> fft;
+
+        std::vector<std::complex<T>> pre;    // e^(-2 pi i low n / rate) e^(-i pi step n^2 / rate)
+        std::vector<std::complex<T>> post;   // e^(-i pi step k^2 / rate)
+        std::vector<std::complex<T>> filter; // spectrum of the conjugate chirp, scaled by 1 / L
+        std::vector<std::complex<T>> work;
+        std::vector<std::complex<T>> spectrum;
+
+        static int fastLength(const int minimum);
+
+    public:
+        ChirpZ(const int size, const int rate, const double low, const double high, const int points);
+
+        void transform(const T* in, T* re, T* im);
+
+        int getSize() const;
+        int getPoints() const;
+        double getLow() const;
+        double getHigh() const;
+        int getLength() const;
+};
+#endif
@@ -0,0 +1,78 @@
+#include "clock.h"
+
+#include <algorithm>
+#include <cmath>
+
+
+Clock* Clock::instance = nullptr;
+
+// the shared clock, real unless set
+Clock& Clock::getInstance() {
+    static RealClock real;
+    return instance ? *instance : real;
+}
+
+void Clock::setInstance(Clock* clock) {
+    instance = clock;
+}
+
+
+//--------------------------------------------------------------------------------------//
+// real
+
+Clock::time_point RealClock::now() const {
+    return std::chrono::steady_clock::now();
+}
+
+void RealClock::waitUntil(std::unique_lock<std::mutex>& lock, std::condition_variable& cv, const time_point due) {
+    cv.wait_until(lock, due);
+}
+
+int RealClock::interval(const int ms) const {
+    return ms;
+}
+
+
+//--------------------------------------------------------------------------------------//
+// simulated
+
+SimulatedClock::SimulatedClock(const double speed) : speed(std::max(0., speed)),
+                                                     start(std::chrono::steady_clock::now()), skipped(0) {}
+
+Clock::time_point SimulatedClock::now() const {
+    duration elapsed(skipped.load());
+    if (speed > 0.)
+        elapsed += duration(static_cast<duration::rep>((std::chrono::steady_clock::now() - start).count() * speed));
+
+    return start + elapsed;
+}
+
+/*
+    Scaled: real wait of (due - now) / speed. Free running: returns at once, time at least due.
+*/
+void SimulatedClock::waitUntil(std::unique_lock<std::mutex>& lock, std::condition_variable& cv, const time_point due) {
+    if (speed > 0.) {
+        const duration ahead = due - now();
+        if (ahead > duration::zero())
+            cv.wait_for(lock, duration(static_cast<duration::rep>(ahead.count() / speed)));
+        return;
+    }
+
+    // several waiters may jump, time only moves forward
+    const duration::rep target = (due - start).count();
+    duration::rep current = skipped.load();
+    while (current < target && !skipped.compare_exchange_weak(current, target)) {}
+}
+
+// at least 1 ms when scaled, a fixed poll when free running (time there follows waits, not ticks)
+int SimulatedClock::interval(const int ms) const {
+    if (speed <= 0.)
+        return CLOCK_FREE_POLL;
+
+    return std::max(1, static_cast<int>(std::lround(ms / speed)));
+}
+
+// times real time, 0 free running
+double SimulatedClock::getSpeed() const {
+    return speed;
+}
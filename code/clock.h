@@ -0,0 +1,90 @@
+#ifndef CLOCK_H
+#define CLOCK_H
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+
+#include "defs.h"
+
+// environment variable selecting a simulated clock at start up, its value is the speed
+#define CLOCK_SPEED_ENV "NEURESET_CLOCK_SPEED"
+// ms between polls of a timer on a free running clock
+#define CLOCK_FREE_POLL 1
+
+
+/*
+    Time source for the device: protocol steps, UI timers and the device date.
+
+    Everything that waits on device time asks the clock rather than std::chrono directly, so a
+    whole session can run on simulated time.
+
+        now         current time, steady (never goes back)
+        waitUntil   sleeps on cv until due or a notify, like condition_variable::wait_until
+        interval    real ms between polls for a timer of ms device time (QTimer). Handlers read
+                    the elapsed time from now rather than count ticks, ticks only pace the display
+
+    One clock is shared, getInstance. setInstance swaps it and must come before the device
+    (Neureset, MainWindow) is built, the caller keeps ownership.
+*/
+class Clock {
+    public:
+        typedef std::chrono::steady_clock::time_point time_point;
+        typedef std::chrono::steady_clock::duration duration;
+
+        virtual ~Clock() = default;
+
+        virtual time_point now() const = 0;
+        virtual void waitUntil(std::unique_lock<std::mutex>& lock, std::condition_variable& cv,
+                               const time_point due) = 0;
+        virtual int interval(const int ms) const = 0;
+
+        static Clock& getInstance();
+        static void setInstance(Clock* clock);
+
+    private:
+        static Clock* instance;
+};
+
+
+/*
+    Wall time, steady_clock. The default.
+*/
+class RealClock : public Clock {
+    public:
+        time_point now() const override;
+        void waitUntil(std::unique_lock<std::mutex>& lock, std::condition_variable& cv,
+                       const time_point due) override;
+        int interval(const int ms) const override;
+};
+
+
+/*
+    Device time decoupled from the wall.
+
+        speed > 0   runs speed times real time, waits are shortened to match
+        speed 0     free running: nothing waits, a wait moves time straight to its deadline, so a
+                    273 s treatment takes as long as its computation
+
+    Free running suits one waiting thread (the protocol scheduler) doing all the timing, e.g.
+    regression runs and throughput tests. Time stands still while nothing waits on it, timers
+    poll every CLOCK_FREE_POLL ms and see it move as the protocol does.
+*/
+class SimulatedClock : public Clock {
+    private:
+        const double speed;
+        const time_point start;
+        std::atomic<duration::rep> skipped;     // time jumped over by waits, free running
+
+    public:
+        explicit SimulatedClock(const double speed = 0.);
+
+        time_point now() const override;
+        void waitUntil(std::unique_lock<std::mutex>& lock, std::condition_variable& cv,
+                       const time_point due) override;
+        int interval(const int ms) const override;
+
+        double getSpeed() const;
+};
+#endif
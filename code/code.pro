@@ -2,30 +2,81 @@ QT       += core gui sql
 
 greaterThan(QT_MAJOR_VERSION, 4): QT += widgets printsupport
 
-CONFIG += c++11
+CONFIG += c++20
 
 # You can make your code fail to compile if it uses deprecated APIs.
 # In order to do so, uncomment the following line.
 #DEFINES += QT_DISABLE_DEPRECATED_BEFORE=0x060000    # disables all the APIs deprecated before Qt 6.0.0
 
+# Single precision signal pipeline (spectrum, sliding DFT, batches), UI data stays double.
+#DEFINES += SAMPLE_FLOAT
+
 SOURCES += \
+    acquisitionworker.cpp \
+    bandpowers.cpp \
+    chirpz.cpp \
+    clock.cpp \
     databasemanager.cpp \
+    dpss.cpp \
+    fft.cpp \
+    filterchain.cpp \
     main.cpp \
     mainwindow.cpp\
+    matrix.cpp \
+    multitaper.cpp \
     neureset.cpp\
+    noisegenerator.cpp \
+    oscillator.cpp \
+    peakrefiner.cpp \
+    protocolscheduler.cpp \
     agent.cpp \
     qcustomplot.cpp \
-    siteinfo.cpp
+    resampler.cpp \
+    simdkernels.cpp \
+    siteinfo.cpp \
+    slidingdft.cpp \
+    spectrogram.cpp \
+    spectralengine.cpp \
+    twiddletable.cpp \
+    wavesynth.cpp \
+    welchpsd.cpp \
+    window.cpp
 
 HEADERS += \
+    acquisitionworker.h \
+    bandpowers.h \
+    chirpz.h \
+    clock.h \
     databasemanager.h \
     defs.h \
+    dpss.h \
+    dsptables.h \
+    fft.h \
+    filterchain.h \
     mainwindow.h\
+    matrix.h \
+    multitaper.h \
     neureset.h\
+    noisegenerator.h \
+    oscillator.h \
+    peakrefiner.h \
+    protocolscheduler.h \
+    protocoltask.h \
+    parallel.h \
     agent.h\
     qcustomplot.h\
+    resampler.h \
     defs.h \
-    siteinfo.h
+    simdkernels.h \
+    siteinfo.h \
+    slidingdft.h \
+    spectrogram.h \
+    spectralengine.h \
+    triplebuffer.h \
+    twiddletable.h \
+    wavesynth.h \
+    welchpsd.h \
+    window.h
 
 FORMS += \
     mainwindow.ui
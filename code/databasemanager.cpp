@@ -31,6 +31,8 @@ void DataBaseManager::DBInit() {
             "CREATE TABLE IF NOT EXISTS Sessions  ( SID INTEGER PRIMARY KEY AUTOINCREMENT, SDATE VARCHAR(30) UNIQUE NOT NULL);");
     stmt.exec(
             "CREATE TABLE IF NOT EXISTS Baselines ( BID INTEGER PRIMARY KEY AUTOINCREMENT,SITE INT, BEFORE DOUBLE, AFTER DOUBLE, SID INT, foreign key (SID) references SESSIONS (SID));");
+    stmt.exec(
+            "CREATE TABLE IF NOT EXISTS BandPowers ( PID INTEGER PRIMARY KEY AUTOINCREMENT, SITE INT, BAND INT, POWER DOUBLE, PEAKFREQ DOUBLE, PEAKAMP DOUBLE, SID INT, foreign key (SID) references SESSIONS (SID));");
     stmt.exec("CREATE TABLE IF NOT EXISTS Date (CurrentDate VARCHAR(30));");
     if (!neuresetDB.commit()) std::cerr << "Error: Fail to initialize the database" << std::endl;
 
@@ -89,6 +91,62 @@ void DataBaseManager::addBaseline(int s, double b, double a, const QString& d) {
     }
 }
 
+// Add per band power and peak of a site to db, one row per band
+void DataBaseManager::addBandPowers(int s, const QVector<BandStats>& bands, const QString& d) {
+    int sid = -1;
+    QSqlQuery stmt(neuresetDB);
+    neuresetDB.transaction();
+
+    stmt.prepare("SELECT sid FROM Sessions WHERE sdate = :date");
+    stmt.bindValue(":date", d);
+    stmt.exec();
+    if (stmt.next()) {
+        sid = stmt.value(0).toInt();
+    } else {
+        std::cerr << "Error: Session ID not found for the given date." << std::endl;
+        neuresetDB.rollback();
+        return;
+    }
+
+    stmt.prepare("INSERT INTO BandPowers (SITE, BAND, POWER, PEAKFREQ, PEAKAMP, SID) VALUES (:s, :band, :p, :f, :a, :sid)");
+    for (int b = 0; b < bands.size(); ++b) {
+        stmt.bindValue(":s", s);
+        stmt.bindValue(":band", b);
+        stmt.bindValue(":p", bands[b].power);
+        stmt.bindValue(":f", bands[b].peakFreq);
+        stmt.bindValue(":a", bands[b].peakAmp);
+        stmt.bindValue(":sid", sid);
+        stmt.exec();
+    }
+
+    if (!neuresetDB.commit()) {
+        std::cerr << "Error: Failed to commit band powers to the database." << std::endl;
+    }
+}
+
+// Get the band powers of a site for a particular date, ordered by band
+QVector<BandStats> DataBaseManager::getBandPowers(int s, const QString& date) {
+    QVector<BandStats> bands(NUM_BRAIN_FREQ);
+    QSqlQuery stmt(neuresetDB);
+
+    stmt.prepare("SELECT BAND, POWER, PEAKFREQ, PEAKAMP FROM BandPowers WHERE SITE = :s AND "
+                 "SID = (SELECT sid FROM Sessions WHERE sdate = :date)");
+    stmt.bindValue(":s", s);
+    stmt.bindValue(":date", date);
+    stmt.exec();
+
+    while (stmt.next()) {
+        const int band = stmt.value(0).toInt();
+        if (band < 0 || band >= NUM_BRAIN_FREQ)
+            continue;
+
+        bands[band].power = stmt.value(1).toDouble();
+        bands[band].peakFreq = stmt.value(2).toDouble();
+        bands[band].peakAmp = stmt.value(3).toDouble();
+    }
+    return bands;
+}
+
 // Get session info from database for display
 QVector<QString> DataBaseManager::getSession() {
     QVector<QString> sessions;
@@ -9,6 +9,7 @@
 #include <QVariant>
 #include <QDebug>
 
+#include "bandpowers.h"
 #include "siteinfo.h"
 #include "defs.h"
 
@@ -19,6 +20,8 @@ public:
     ~DataBaseManager();
     void addSession(const QString& date);
     void addBaseline(int s, double b, double a, const QString& date);
+    void addBandPowers(int s, const QVector<BandStats>& bands, const QString& date);
+    QVector<BandStats> getBandPowers(int s, const QString& date);
     QVector<QString> getSession();
     QVector<SiteInfo*> getSiteRecords(const QString& date);
     QString getDate();
@@ -10,10 +10,28 @@
 #define NOISE_FLOOR 10.
 #define NUM_OFFSETS 4
 
+// delta, theta, alpha, beta - synthesized by Agent, measured by BandPowers (hz)
+#define BAND_CENTERS {2.5, 6., 10., 21.}
+#define BAND_OFFSETS {1.5, 2., 2., 9.}
+#define BAND_AMPS {50., 40., 35., 25.} // uv, +- BAND_AMP_SPREAD
+#define BAND_AMP_SPREAD 5.
+#define SPECTROGRAM_DEPTH 256 // frames of spectrum history per site, ~16 s at REFRESH_PERIOD
+#define ZOOM_MAX_POINTS 4096 // chirp-z bins, ~0.025 hz over the whole band
+
+// default front end filters, biquads
+#define FILTER_HIGHPASS 0.1 // hz, drift out, low enough that the transient from rest leaves 1 hz peaks alone
+#define FILTER_NOTCH 60. // hz mains, 50. outside north america
+#define FILTER_NOTCH_Q 30.
+#define FILTER_LOWPASS 45. // hz, above beta
+#define FILTER_Q 0.707 // butterworth
+
 // anyone who change the total time here (in seconds)
 // pre treatment delay: 5. before and after delay of treatments 2 * 4 offsets: 8
 // 13 * 21 = 273
 #define TREATMENT_TIME 273
+#define TREATMENT_STEP 1000 // ms per protocol step
+#define PRETREATMENT_STEPS 5 // baseline samples, one per step
+#define DISCONNECT_TIMEOUT 300000 // ms without contact in session before power off
 // three full treatments: 273 * 3 = 819 total battery life
 #define BATTERY_CAPACITY TREATMENT_TIME * 3
 
@@ -26,4 +44,11 @@
 
 #define DB_PATH "/neureset.db"
 
+// signal pipeline precision - DEFINES += SAMPLE_FLOAT halves memory traffic and doubles SIMD width
+#ifdef SAMPLE_FLOAT
+typedef float sample_t;
+#else
+typedef double sample_t;
+#endif
+
 #endif // DEFS_H
@@ -0,0 +1,174 @@
+#include "dpss.h"
+
+#include <algorithm>
+#include <limits>
+#include <vector>
+
+template <typename T>
+std::mutex DpssTapers<T>::cacheMtx;
+
+template <typename T>
+std::map<std::tuple<int, double, int>, std::weak_ptr<const DpssTapers<T>>> DpssTapers<T>::cache;
+
+
+template <typename T>
+DpssTapers<T>::DpssTapers(const int size, const double nw, const int count) :
+        size(size), count(count), nw(nw), tapers(new T[count * size]()) {
+    solve();
+}
+
+template <typename T>
+DpssTapers<T>::~DpssTapers() {
+    delete[] tapers;
+}
+
+
+/*
+    Tridiagonal DPSS matrix, implicit QL with shifts, all eigenvectors.
+
+        diagonal  ((size - 1) / 2 - n)^2 cos(2 pi w)
+        off       (n + 1)(size - n - 1) / 2
+
+    O(size^3), only run once per configuration.
+*/
+template <typename T>
+void DpssTapers<T>::solve() {
+    const int n = size;
+    const double w = nw / n;
+
+    std::vector<double> d(n);
+    std::vector<double> e(n, 0.);
+    std::vector<double> z(static_cast<std::size_t>(n) * n, 0.); // column j is eigenvector j
+
+    for (int i = 0; i < n; ++i) {
+        const double centre = (n - 1) / 2. - i;
+        d[i] = centre * centre * std::cos(2. * PI * w);
+        z[i * n + i] = 1.;
+    }
+    for (int i = 0; i < n - 1; ++i)
+        e[i] = (i + 1) * (n - i - 1) / 2.;
+
+    const double epsilon = std::numeric_limits<double>::epsilon();
+
+    for (int l = 0; l < n; ++l) {
+        for (int iteration = 0; iteration < 64; ++iteration) {
+            int m = l;
+            for (; m < n - 1; ++m)
+                if (std::abs(e[m]) <= epsilon * (std::abs(d[m]) + std::abs(d[m + 1])))
+                    break;
+
+            if (m == l)
+                break;
+
+            double g = (d[l + 1] - d[l]) / (2. * e[l]);
+            double r = std::hypot(g, 1.);
+            g = d[m] - d[l] + e[l] / (g + std::copysign(r, g));
+
+            double s = 1.;
+            double c = 1.;
+            double p = 0.;
+            int i = m - 1;
+
+            for (; i >= l; --i) {
+                const double f = s * e[i];
+                const double b = c * e[i];
+                r = std::hypot(f, g);
+                e[i + 1] = r;
+
+                if (r == 0.) {
+                    d[i + 1] -= p;
+                    e[m] = 0.;
+                    break;
+                }
+
+                s = f / r;
+                c = g / r;
+                g = d[i + 1] - p;
+                r = (d[i] - g) * s + 2. * c * b;
+                p = s * r;
+                d[i + 1] = g + p;
+                g = c * r - b;
+
+                for (int k = 0; k < n; ++k) {
+                    const double t = z[k * n + i + 1];
+                    z[k * n + i + 1] = s * z[k * n + i] + c * t;
+                    z[k * n + i] = c * z[k * n + i] - s * t;
+                }
+            }
+
+            if (r == 0. && i >= l)
+                continue;
+
+            d[l] -= p;
+            e[l] = g;
+            e[m] = 0.;
+        }
+    }
+
+    // largest eigenvalues are the most concentrated tapers
+    std::vector<int> order(n);
+    for (int i = 0; i < n; ++i)
+        order[i] = i;
+    std::sort(order.begin(), order.end(), [&d](const int a, const int b) { return d[a] > d[b]; });
+
+    for (int k = 0; k < count && k < n; ++k) {
+        const int column = order[k];
+        double energy = 0.;
+        double sum = 0.;
+
+        for (int i = 0; i < n; ++i) {
+            energy += z[i * n + column] * z[i * n + column];
+            sum += z[i * n + column] * (k % 2 ? (n - 1) / 2. - i : 1.);
+        }
+
+        // unit energy, symmetric tapers sum positive, antisymmetric start positive
+        const double norm = (sum < 0. ? -1. : 1.) / std::sqrt(energy);
+
+        for (int i = 0; i < n; ++i)
+            tapers[k * size + i] = static_cast<T>(z[i * n + column] * norm);
+    }
+}
+
+
+/*
+    Shared tapers for a configuration, solved on first request.
+*/
+template <typename T>
+std::shared_ptr<const DpssTapers<T>> DpssTapers<T>::get(const int size, const double nw, const int count) {
+    std::lock_guard<std::mutex> lock(cacheMtx);
+
+    const std::tuple<int, double, int> key(size, nw, count);
+    std::shared_ptr<const DpssTapers<T>> tapers = cache[key].lock();
+
+    if (!tapers) {
+        tapers = std::shared_ptr<const DpssTapers<T>>(new DpssTapers<T>(size, nw, count));
+        cache[key] = tapers;
+    }
+
+    return tapers;
+}
+
+
+template <typename T>
+const T* DpssTapers<T>::getTaper(const int k) const {
+    return tapers + k * size;
+}
+
+template <typename T>
+int DpssTapers<T>::getSize() const {
+    return size;
+}
+
+template <typename T>
+int DpssTapers<T>::getCount() const {
+    return count;
+}
+
+template <typename T>
+double DpssTapers<T>::getNW() const {
+    return nw;
+}
+
+
+template class DpssTapers<float>;
+template class DpssTapers<double>;
@@ -0,0 +1,47 @@
+#ifndef DPSS_H
+#define DPSS_H
+
+#include <cmath>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <tuple>
+
+#include "defs.h"
+
+
+/*
+    Discrete prolate spheroidal (Slepian) tapers.
+
+    The count most concentrated sequences of size samples within half bandwidth nw / size,
+    eigenvectors of the symmetric tridiagonal DPSS matrix. Unit energy, tapers x size rows.
+
+    Shared and cached per (size, nw, count) like TwiddleTable, solved once per configuration.
+*/
+template <typename T>
+class DpssTapers {
+    private:
+        const int size;
+        const int count;
+        const double nw;
+
+        T* const tapers;
+
+        static std::mutex cacheMtx;
+        static std::map<std::tuple<int, double, int>, std::weak_ptr<const DpssTapers<T>>> cache;
+
+        DpssTapers(const int size, const double nw, const int count);
+        void solve();
+
+    public:
+        ~DpssTapers();
+
+        static std::shared_ptr<const DpssTapers<T>> get(const int size, const double nw, const int count);
+
+        const T* getTaper(const int k) const;
+
+        int getSize() const;
+        int getCount() const;
+        double getNW() const;
+};
+#endif
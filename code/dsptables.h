@@ -0,0 +1,125 @@
+#ifndef DSPTABLES_H
+#define DSPTABLES_H
+
+#include <cmath>
+#include <complex>
+
+#include "defs.h"
+
+// default configuration, generated at compile time
+#define DSP_TABLE_RATE (MAX_FREQ * MAX_SAMPLES)
+#define DSP_TABLE_PERIOD (2 * DSP_TABLE_RATE) // zero padded spectrum length
+
+
+/*
+    cos and sin of 2 pi m / length, constexpr.
+
+    Quadrant is found with integer arithmetic so the Taylor series only sees [0, pi / 2).
+*/
+constexpr double constexprTaylor(const double x, const bool sine) {
+    double term = sine ? x : 1.;
+    double sum = term;
+
+    for (int k = sine ? 2 : 1; k < 14; ++k) {
+        const int a = sine ? 2 * k - 2 : 2 * k - 1;
+        term *= -x * x / (a * (a + 1));
+        sum += term;
+    }
+
+    return sum;
+}
+
+constexpr double constexprUnit(const long long m, const long long length, const bool sine) {
+    const long long wrapped = ((m % length) + length) % length;
+    const long long quadrant = 4 * wrapped / length;
+    const long long rest = 4 * wrapped - quadrant * length;
+    const double x = (PI / 2.) * static_cast<double>(rest) / static_cast<double>(length);
+
+    const double c = constexprTaylor(x, false);
+    const double s = constexprTaylor(x, true);
+
+    switch (quadrant) {
+        case 0: return sine ? s : c;
+        case 1: return sine ? c : -s;
+        case 2: return sine ? -s : -c;
+        default: return sine ? -c : s;
+    }
+}
+
+
+template <int LENGTH>
+struct UnitCircle {
+    double cosine[LENGTH];
+    double sine[LENGTH];
+};
+
+template <int LENGTH>
+constexpr UnitCircle<LENGTH> makeUnitCircle() {
+    UnitCircle<LENGTH> circle{};
+
+    for (int m = 0; m < LENGTH; ++m) {
+        circle.cosine[m] = constexprUnit(m, LENGTH, false);
+        circle.sine[m] = constexprUnit(m, LENGTH, true);
+    }
+
+    return circle;
+}
+
+
+template <int NUM>
+struct Axis {
+    double values[NUM];
+};
+
+// same arithmetic as the runtime linspace
+template <int START, int END, int NUM>
+constexpr Axis<NUM> makeLinspace() {
+    Axis<NUM> axis{};
+    const double step = static_cast<double>(END - START) / NUM;
+
+    for (int i = 0; i < NUM; ++i)
+        axis.values[i] = START + i * step;
+
+    return axis;
+}
+
+
+/*
+    Lookup tables for the default sampling rate, no trigonometry at startup.
+
+    Other sample rates fall back to runtime computation.
+*/
+class DspTables {
+    public:
+        static constexpr UnitCircle<DSP_TABLE_PERIOD> circle = makeUnitCircle<DSP_TABLE_PERIOD>();
+        static constexpr Axis<DSP_TABLE_RATE> time = makeLinspace<0, 1, DSP_TABLE_RATE>();
+        static constexpr Axis<DSP_TABLE_RATE / 2> freq = makeLinspace<0, MAX_FREQ, DSP_TABLE_RATE / 2>();
+
+        /*
+            e^(2 pi i m / length).
+
+            Table lookup when length divides the table period, std::polar otherwise.
+        */
+        static std::complex<double> phasor(const int length, const long long m) {
+            if (DSP_TABLE_PERIOD % length == 0) {
+                const long long index = ((m % length + length) % length) * (DSP_TABLE_PERIOD / length);
+                return std::complex<double>(circle.cosine[index], circle.sine[index]);
+            }
+
+            const double angle = 2. * PI * static_cast<double>(m % length) / length;
+            return std::polar(1., angle);
+        }
+
+        /*
+            Precomputed linspace(start, end, num), null when not generated.
+        */
+        static const double* axis(const int start, const int end, const int num) {
+            if (start == 0 && end == 1 && num == DSP_TABLE_RATE)
+                return time.values;
+            if (start == 0 && end == MAX_FREQ && num == DSP_TABLE_RATE / 2)
+                return freq.values;
+
+            return nullptr;
+        }
+};
+#endif
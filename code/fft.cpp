@@ -0,0 +1,199 @@
+#include "fft.h"
+
+
+/*
+    Plain complex product.
+
+    std::complex operator* goes through the C99 inf / nan recovery (__muldc3) unless
+    built with -ffast-math, several times slower in the butterflies.
+*/
+template <typename T>
+static inline std::complex<T> mul(const std::complex<T>& a, const std::complex<T>& b) {
+    return std::complex<T>(a.real() * b.real() - a.imag() * b.imag(),
+                                a.real() * b.imag() + a.imag() * b.real());
+}
+
+
+template <typename T>
+ComplexFFT<T>::ComplexFFT(const int length) : length(length), table(PhasorTable<T>::get(length)),
+                                              twiddles(table->getPhasors()), buffer(length) {
+    factorize();
+}
+
+
+/*
+    Splits the length into radices, largest specialized radix first.
+
+    Stored as (radix, remaining length) pairs consumed by work().
+*/
+template <typename T>
+void ComplexFFT<T>::factorize() {
+    int n = length;
+    int p = 4;
+    int largest = 1;
+
+    while (n > 1) {
+        while (n % p) {
+            switch (p) {
+                case 4: p = 2; break;
+                case 2: p = 3; break;
+                default: p += 2; break;
+            }
+            if (p * p > n)
+                p = n; // n is prime
+        }
+        n /= p;
+        factors.push_back(p);
+        factors.push_back(n);
+        largest = std::max(largest, p);
+    }
+
+    if (factors.empty()) { // length 1, identity
+        factors.push_back(1);
+        factors.push_back(1);
+    }
+
+    scratch.resize(largest);
+}
+
+
+/*
+    Recursive decimation in time.
+
+    Each level splits into p interleaved sub-sequences of length m, then recombines with a radix p butterfly.
+*/
+template <typename T>
+void ComplexFFT<T>::work(std::complex<T>* out, const std::complex<T>* in, const int stride, const int* factor) {
+    const int p = factor[0];
+    const int m = factor[1];
+    std::complex<T>* const begin = out;
+    std::complex<T>* const end = out + p * m;
+
+    if (m == 1) {
+        for (; out != end; ++out, in += stride)
+            *out = *in;
+    } else {
+        for (; out != end; out += m, in += stride)
+            work(out, in, stride * p, factor + 2);
+    }
+
+    switch (p) {
+        case 2: butterfly2(begin, stride, m); break;
+        case 3: butterfly3(begin, stride, m); break;
+        case 4: butterfly4(begin, stride, m); break;
+        default: butterflyGeneric(begin, stride, p, m); break;
+    }
+}
+
+
+template <typename T>
+void ComplexFFT<T>::butterfly2(std::complex<T>* out, const int stride, const int m) {
+    std::complex<T>* out2 = out + m;
+
+    for (int u = 0; u < m; ++u) {
+        const std::complex<T> t = mul(out2[u], twiddles[u * stride]);
+        out2[u] = out[u] - t;
+        out[u] += t;
+    }
+}
+
+
+template <typename T>
+void ComplexFFT<T>::butterfly3(std::complex<T>* out, const int stride, const int m) {
+    const T sin60 = twiddles[stride * m].imag(); // -sin(2 pi / 3)
+
+    for (int u = 0; u < m; ++u) {
+        const std::complex<T> a1 = mul(out[u + m], twiddles[u * stride]);
+        const std::complex<T> a2 = mul(out[u + 2 * m], twiddles[2 * u * stride]);
+
+        const std::complex<T> sum = a1 + a2;
+        const std::complex<T> diff = (a1 - a2) * sin60;
+        const std::complex<T> mid = out[u] - sum * T(0.5);
+
+        out[u] += sum;
+        out[u + m] = std::complex<T>(mid.real() - diff.imag(), mid.imag() + diff.real());
+        out[u + 2 * m] = std::complex<T>(mid.real() + diff.imag(), mid.imag() - diff.real());
+    }
+}
+
+
+template <typename T>
+void ComplexFFT<T>::butterfly4(std::complex<T>* out, const int stride, const int m) {
+    for (int u = 0; u < m; ++u) {
+        const std::complex<T> a0 = out[u];
+        const std::complex<T> a1 = mul(out[u + m], twiddles[u * stride]);
+        const std::complex<T> a2 = mul(out[u + 2 * m], twiddles[2 * u * stride]);
+        const std::complex<T> a3 = mul(out[u + 3 * m], twiddles[3 * u * stride]);
+
+        const std::complex<T> s0 = a0 + a2;
+        const std::complex<T> s1 = a0 - a2;
+        const std::complex<T> s2 = a1 + a3;
+        const std::complex<T> s3 = a1 - a3;
+
+        // multiply by -i
+        const std::complex<T> r3(s3.imag(), -s3.real());
+
+        out[u] = s0 + s2;
+        out[u + m] = s1 + r3;
+        out[u + 2 * m] = s0 - s2;
+        out[u + 3 * m] = s1 - r3;
+    }
+}
+
+
+/*
+    Any prime radix, O(p^2) per group.
+*/
+template <typename T>
+void ComplexFFT<T>::butterflyGeneric(std::complex<T>* out, const int stride, const int p, const int m) {
+    for (int u = 0; u < m; ++u) {
+        for (int q = 0, k = u; q < p; ++q, k += m)
+            scratch[q] = out[k];
+
+        for (int q1 = 0, k = u; q1 < p; ++q1, k += m) {
+            int index = 0;
+            out[k] = scratch[0];
+
+            for (int q = 1; q < p; ++q) {
+                index += stride * k;
+                if (index >= length)
+                    index -= length;
+                out[k] += mul(scratch[q], twiddles[index]);
+            }
+        }
+    }
+}
+
+
+/*
+    Forward transform, X[k] = sum x[n] e^(-2 pi i k n / length).
+*/
+template <typename T>
+void ComplexFFT<T>::forward(const std::complex<T>* in, std::complex<T>* out) {
+    work(out, in, 1, factors.data());
+}
+
+
+/*
+    Inverse by conjugation, not scaled by 1 / length.
+*/
+template <typename T>
+void ComplexFFT<T>::inverse(const std::complex<T>* in, std::complex<T>* out) {
+    for (int i = 0; i < length; ++i)
+        buffer[i] = std::conj(in[i]);
+
+    work(out, buffer.data(), 1, factors.data());
+
+    for (int i = 0; i < length; ++i)
+        out[i] = std::conj(out[i]);
+}
+
+
+template <typename T>
+int ComplexFFT<T>::getLength() const {
+    return length;
+}
+
+
+template class ComplexFFT<float>;
+template class ComplexFFT<double>;
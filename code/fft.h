@@ -0,0 +1,51 @@
+#ifndef FFT_H
+#define FFT_H
+
+#include <complex>
+#include <memory>
+#include <vector>
+
+#include "defs.h"
+#include "dsptables.h"
+#include "twiddletable.h"
+
+
+/*
+    Mixed-radix complex FFT of any length.
+
+    Length is factored into 4, 2, 3, 5 and whatever primes remain (generic butterfly),
+    so non power of two sizes such as 2 * MAX_FREQ * MAX_SAMPLES run in O(n * sum(factors)).
+
+    Twiddles come from the shared PhasorTable of the length.
+
+    Instantiated for float and double.
+*/
+template <typename T>
+class ComplexFFT {
+    private:
+        const int length;
+
+        std::vector<int> factors;                   // pairs of (radix, remaining length)
+        const std::shared_ptr<const PhasorTable<T>> table;
+        const std::complex<T>* const twiddles;  // e^(-2 pi i j / length), shared per length
+        std::vector<std::complex<T>> scratch;  // generic butterfly, size of largest radix
+        std::vector<std::complex<T>> buffer;   // conjugated input for inverse
+
+        void factorize();
+        void work(std::complex<T>* out, const std::complex<T>* in, const int stride, const int* factor);
+
+        void butterfly2(std::complex<T>* out, const int stride, const int m);
+        void butterfly3(std::complex<T>* out, const int stride, const int m);
+        void butterfly4(std::complex<T>* out, const int stride, const int m);
+        void butterflyGeneric(std::complex<T>* out, const int stride, const int p, const int m);
+
+    public:
+        explicit ComplexFFT(const int length);
+
+        // out must not alias in
+        void forward(const std::complex<T>* in, std::complex<T>* out);
+        void inverse(const std::complex<T>* in, std::complex<T>* out); // unscaled
+
+        int getLength() const;
+};
+#endif
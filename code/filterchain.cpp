@@ -0,0 +1,291 @@
+#include "filterchain.h"
+
+
+template <typename T>
+FilterStage<T>::FilterStage(const int channels) : channels(channels) {}
+
+template <typename T>
+FilterStage<T>::~FilterStage() {}
+
+template <typename T>
+int FilterStage<T>::getChannels() const {
+    return channels;
+}
+
+
+//--------------------------------------------------------------------------------------//
+// biquad
+
+template <typename T>
+Biquad<T>::Biquad(const int channels, const double b0, const double b1, const double b2,
+                  const double a0, const double a1, const double a2) :
+        FilterStage<T>(channels),
+        coefficients{static_cast<T>(b0 / a0), static_cast<T>(b1 / a0), static_cast<T>(b2 / a0),
+                     static_cast<T>(a1 / a0), static_cast<T>(a2 / a0)},
+        z1(new T[channels]()), z2(new T[channels]()) {}
+
+template <typename T>
+Biquad<T>::~Biquad() {
+    delete[] z1;
+    delete[] z2;
+}
+
+
+/*
+    All channels, one register of channels at a time with state held over the block.
+*/
+template <typename T>
+void Biquad<T>::process(T* data, const int frames) {
+    SimdKernels::biquad(data, frames, this->channels, coefficients, z1, z2);
+}
+
+template <typename T>
+void Biquad<T>::processChannel(const int channel, T* data, const int frames) {
+    SimdKernels::biquad(data, frames, 1, coefficients, z1 + channel, z2 + channel);
+}
+
+template <typename T>
+void Biquad<T>::reset() {
+    for (int c = 0; c < this->channels; ++c)
+        reset(c);
+}
+
+template <typename T>
+void Biquad<T>::reset(const int channel) {
+    z1[channel] = 0;
+    z2[channel] = 0;
+}
+
+
+/*
+    Mains rejection, unity gain away from freq. Bandwidth freq / q.
+*/
+template <typename T>
+Biquad<T>* Biquad<T>::notch(const int channels, const int rate, const double freq, const double q) {
+    const double w = 2. * PI * freq / rate;
+    const double alpha = std::sin(w) / (2. * q);
+    const double cosine = std::cos(w);
+
+    return new Biquad<T>(channels, 1., -2. * cosine, 1., 1. + alpha, -2. * cosine, 1. - alpha);
+}
+
+/*
+    Drift removal. q = 1 / sqrt(2) for butterworth.
+*/
+template <typename T>
+Biquad<T>* Biquad<T>::highpass(const int channels, const int rate, const double cutoff, const double q) {
+    const double w = 2. * PI * cutoff / rate;
+    const double alpha = std::sin(w) / (2. * q);
+    const double cosine = std::cos(w);
+
+    return new Biquad<T>(channels, (1. + cosine) / 2., -(1. + cosine), (1. + cosine) / 2.,
+                         1. + alpha, -2. * cosine, 1. - alpha);
+}
+
+/*
+    Anti-alias. q = 1 / sqrt(2) for butterworth.
+*/
+template <typename T>
+Biquad<T>* Biquad<T>::lowpass(const int channels, const int rate, const double cutoff, const double q) {
+    const double w = 2. * PI * cutoff / rate;
+    const double alpha = std::sin(w) / (2. * q);
+    const double cosine = std::cos(w);
+
+    return new Biquad<T>(channels, (1. - cosine) / 2., 1. - cosine, (1. - cosine) / 2.,
+                         1. + alpha, -2. * cosine, 1. - alpha);
+}
+
+
+//--------------------------------------------------------------------------------------//
+// fir
+
+template <typename T>
+FirFilter<T>::FirFilter(const int channels, const std::vector<double>& taps) :
+        FilterStage<T>(channels), taps(taps.begin(), taps.end()) {
+    if (this->taps.empty())
+        this->taps.push_back(T(1));
+
+    history.assign((this->taps.size() - 1) * channels, T(0));
+}
+
+
+/*
+    y[n] = sum h[t] x[n - t] over history then block, one axpy per tap.
+*/
+template <typename T>
+void FirFilter<T>::process(T* data, const int frames) {
+    const int channels = this->channels;
+    const int count = static_cast<int>(taps.size());
+    const int past = count - 1;
+    const int total = frames * channels;
+
+    extended.resize(static_cast<std::size_t>(past + frames) * channels);
+    std::copy(history.begin(), history.end(), extended.begin());
+    std::copy(data, data + total, extended.begin() + past * channels);
+
+    // output tiles stay in L1 across taps
+    for (int first = 0; first < total; first += FIR_TILE) {
+        const int length = std::min(FIR_TILE, total - first);
+        std::fill(data + first, data + first + length, T(0));
+
+        for (int t = 0; t < count; ++t)
+            SimdKernels::axpy(taps[t], extended.data() + (past - t) * channels + first, data + first, length);
+    }
+
+    std::copy(extended.end() - past * channels, extended.end(), history.begin());
+}
+
+template <typename T>
+void FirFilter<T>::processChannel(const int channel, T* data, const int frames) {
+    const int channels = this->channels;
+    const int count = static_cast<int>(taps.size());
+    const int past = count - 1;
+
+    extended.resize(static_cast<std::size_t>(past + frames));
+    for (int i = 0; i < past; ++i)
+        extended[i] = history[i * channels + channel];
+    std::copy(data, data + frames, extended.begin() + past);
+
+    std::fill(data, data + frames, T(0));
+    for (int t = 0; t < count; ++t)
+        SimdKernels::axpy(taps[t], extended.data() + past - t, data, frames);
+
+    for (int i = 0; i < past; ++i)
+        history[i * channels + channel] = extended[frames + i];
+}
+
+template <typename T>
+void FirFilter<T>::reset() {
+    std::fill(history.begin(), history.end(), T(0));
+}
+
+template <typename T>
+void FirFilter<T>::reset(const int channel) {
+    for (std::size_t i = channel; i < history.size(); i += this->channels)
+        history[i] = 0;
+}
+
+
+/*
+    Windowed sinc, count taps (odd keeps it linear phase with integer delay), unity dc gain.
+*/
+template <typename T>
+FirFilter<T>* FirFilter<T>::lowpass(const int channels, const int rate, const double cutoff, const int count,
+                                    const Window::Type type) {
+    const int length = std::max(1, count);
+    std::vector<double> window(length);
+    std::vector<double> taps(length);
+
+    // symmetric taper: periodic of length - 1, closed with its first value
+    Window::fill(type, window.data(), std::max(1, length - 1));
+    if (length > 1)
+        window[length - 1] = window[0];
+
+    const double fc = cutoff / rate;
+    const double centre = (length - 1) / 2.;
+    double sum = 0.;
+
+    for (int i = 0; i < length; ++i) {
+        const double x = i - centre;
+        const double sinc = x == 0. ? 2. * fc : std::sin(2. * PI * fc * x) / (PI * x);
+        taps[i] = sinc * (length > 1 ? window[i] : 1.);
+        sum += taps[i];
+    }
+
+    for (int i = 0; i < length; ++i)
+        taps[i] /= sum;
+
+    return new FirFilter<T>(channels, taps);
+}
+
+
+//--------------------------------------------------------------------------------------//
+// chain
+
+template <typename T>
+FilterChain<T>::FilterChain(const int channels) : channels(channels) {}
+
+template <typename T>
+FilterChain<T>::~FilterChain() {
+    clear();
+}
+
+
+/*
+    Appends a stage, takes ownership. Stages with a different channel count are rejected (deleted).
+*/
+template <typename T>
+bool FilterChain<T>::add(FilterStage<T>* stage) {
+    if (!stage)
+        return false;
+
+    if (stage->getChannels() != channels) {
+        delete stage;
+        return false;
+    }
+
+    stages.push_back(stage);
+    return true;
+}
+
+template <typename T>
+void FilterChain<T>::clear() {
+    for (FilterStage<T>* stage : stages)
+        delete stage;
+    stages.clear();
+}
+
+template <typename T>
+void FilterChain<T>::process(T* data, const int frames) {
+    for (FilterStage<T>* stage : stages)
+        stage->process(data, frames);
+}
+
+template <typename T>
+void FilterChain<T>::processChannel(const int channel, T* data, const int frames) {
+    if (channel < 0 || channel >= channels)
+        return;
+
+    for (FilterStage<T>* stage : stages)
+        stage->processChannel(channel, data, frames);
+}
+
+template <typename T>
+void FilterChain<T>::reset() {
+    for (FilterStage<T>* stage : stages)
+        stage->reset();
+}
+
+template <typename T>
+void FilterChain<T>::reset(const int channel) {
+    if (channel < 0 || channel >= channels)
+        return;
+
+    for (FilterStage<T>* stage : stages)
+        stage->reset(channel);
+}
+
+template <typename T>
+bool FilterChain<T>::isEmpty() const {
+    return stages.empty();
+}
+
+template <typename T>
+int FilterChain<T>::getChannels() const {
+    return channels;
+}
+
+template <typename T>
+int FilterChain<T>::getStages() const {
+    return static_cast<int>(stages.size());
+}
+
+
+template class FilterStage<float>;
+template class FilterStage<double>;
+template class Biquad<float>;
+template class Biquad<double>;
+template class FirFilter<float>;
+template class FirFilter<double>;
+template class FilterChain<float>;
+template class FilterChain<double>;
@@ -0,0 +1,130 @@
+#ifndef FILTERCHAIN_H
+#define FILTERCHAIN_H
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+#include "defs.h"
+#include "simdkernels.h"
+#include "window.h"
+
+// samples of output per fir tile, small enough to stay in L1 across all taps
+#define FIR_TILE 1024
+
+
+/*
+    One stage of a multi-channel filter with state kept between blocks.
+
+    Blocks are interleaved, frame major: data[n * channels + c]. Every stage runs across channels
+    with shared coefficients and no dependency between lanes, through the SimdKernels filter
+    kernels, so all sites are filtered for a fraction of the cost of one at a time.
+
+    processChannel filters a contiguous block of a single channel with the same state,
+    used by the live path which only generates the selected site.
+
+    Instantiated for float and double.
+*/
+template <typename T>
+class FilterStage {
+    protected:
+        const int channels;
+
+    public:
+        explicit FilterStage(const int channels);
+        virtual ~FilterStage();
+
+        virtual void process(T* data, const int frames) = 0;
+        virtual void processChannel(const int channel, T* data, const int frames) = 0;
+        virtual void reset() = 0;
+        virtual void reset(const int channel) = 0;
+
+        int getChannels() const;
+};
+
+
+/*
+    Second order IIR section, transposed direct form II.
+
+        y = b0 x + z1
+        z1 = b1 x - a1 y + z2
+        z2 = b2 x - a2 y
+
+    Coefficients from the RBJ audio EQ cookbook, normalized by a0.
+*/
+template <typename T>
+class Biquad : public FilterStage<T> {
+    private:
+        T coefficients[5]; // b0, b1, b2, a1, a2
+
+        T* const z1;
+        T* const z2;
+
+    public:
+        Biquad(const int channels, const double b0, const double b1, const double b2,
+               const double a0, const double a1, const double a2);
+        ~Biquad();
+
+        void process(T* data, const int frames) override;
+        void processChannel(const int channel, T* data, const int frames) override;
+        void reset() override;
+        void reset(const int channel) override;
+
+        static Biquad<T>* notch(const int channels, const int rate, const double freq, const double q);
+        static Biquad<T>* highpass(const int channels, const int rate, const double cutoff, const double q);
+        static Biquad<T>* lowpass(const int channels, const int rate, const double cutoff, const double q);
+};
+
+
+/*
+    Finite impulse response stage, direct convolution.
+
+    taps - 1 frames of history per channel carry the convolution across blocks. Interleaved frames
+    are contiguous across n and c alike, so each tap is one axpy over the whole block.
+*/
+template <typename T>
+class FirFilter : public FilterStage<T> {
+    private:
+        std::vector<T> taps;
+        std::vector<T> history;  // (taps - 1) x channels, oldest first
+        std::vector<T> extended; // history followed by the block
+
+    public:
+        FirFilter(const int channels, const std::vector<double>& taps);
+
+        void process(T* data, const int frames) override;
+        void processChannel(const int channel, T* data, const int frames) override;
+        void reset() override;
+        void reset(const int channel) override;
+
+        static FirFilter<T>* lowpass(const int channels, const int rate, const double cutoff, const int count,
+                                     const Window::Type type);
+};
+
+
+/*
+    Stages applied in order, owns them. An empty chain passes data through.
+*/
+template <typename T>
+class FilterChain {
+    private:
+        const int channels;
+        std::vector<FilterStage<T>*> stages;
+
+    public:
+        explicit FilterChain(const int channels);
+        ~FilterChain();
+
+        bool add(FilterStage<T>* stage);
+        void clear();
+
+        void process(T* data, const int frames);
+        void processChannel(const int channel, T* data, const int frames);
+        void reset();
+        void reset(const int channel);
+
+        bool isEmpty() const;
+        int getChannels() const;
+        int getStages() const;
+};
+#endif
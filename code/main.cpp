@@ -1,9 +1,20 @@
 #include "mainwindow.h"
 
 #include <QApplication>
+#include <cstdlib>
+#include <memory>
 
 int main(int argc, char *argv[]) {
     QApplication a(argc, argv);
+
+    // NEURESET_CLOCK_SPEED=x runs the device x times real time, 0 as fast as it computes.
+    // declared before the window so it outlives it
+    std::unique_ptr<SimulatedClock> simulated;
+    if (const char* speed = std::getenv(CLOCK_SPEED_ENV)) {
+        simulated.reset(new SimulatedClock(std::atof(speed)));
+        Clock::setInstance(simulated.get());
+    }
+
     MainWindow w;
     w.show();
     return a.exec();
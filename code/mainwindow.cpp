@@ -10,19 +10,12 @@ MainWindow::MainWindow(QWidget *parent) :
 
         neureset(Neureset::getInstance()),
         agent(new Agent(neureset)),
+        clock(Clock::getInstance()),
         //--------------------------------------------------------------------------------------//
         // references to neureset
         domainTime(neureset->getDomainTime()),
-        ampTime(neureset->getAmpTime()),
-
         domainDFT(neureset->getDomainDFT()),
-        ampDFT(neureset->getAmpDFT()),
-
-        peakFreq(neureset->getDomFreq()),
-        peakFreqAmp(neureset->getPeakFreqAmp()),
-        progress(neureset->getProgress()),
-        treatAmp(neureset->getTreatAmp()),
-        mtx(neureset->getMutex()),
+        lastFrame(-1),
         //--------------------------------------------------------------------------------------//
         site(0),
         isAttached(false),
@@ -30,14 +23,16 @@ MainWindow::MainWindow(QWidget *parent) :
         isInSession(false),
         isInMenu(true),
         isInHistory(false),
-        isPower(false) {
+        isPower(false),
+        treatmentSession(-1),
+        disconnectSession(-1) {
 
     ui->setupUi(this);
     instance = this;
     dbManager = new DataBaseManager("main");
     loader();
     //update the clock per second
-    deviceClock->start(1000);
+    deviceClock->start(clock.interval(1000));
 
     // attach the helmet
     agent->helmet();
@@ -48,12 +43,16 @@ MainWindow::MainWindow(QWidget *parent) :
 MainWindow::~MainWindow() {
 
     refresh->stop();
+    acquisition->stop();
     stopTreatment();
+    stopDisconnectTimer();
 
-    future.waitForFinished();
+    // the session coroutine unwinds on the scheduler thread, wait for it
+    neureset->getScheduler().flush();
 
     delete db;
     delete dbManager;
+    delete acquisition;
     delete neureset;
     delete agent;
     delete ui;
@@ -89,13 +88,15 @@ void MainWindow::loader() {
     //Set default device date and time to 2024-01-01 00:00:00
     QString date = dbManager->getDate();
     currentDateTime = QDateTime::fromString(date, "yyyy-MM-dd HH:mm:ss");
+    dateSet = clock.now();
 
-    //device clock, update the device time every minute
+    //device clock, update the device time every second of clock time
     deviceClock = new QTimer(this);
     connect(deviceClock, SIGNAL(timeout()), this, SLOT(updateTime()));
 
     //--------------------------------------------------------------------------------------//
-    // timer - update charts
+    // worker - produces frames, timer - draws the latest
+    acquisition = new AcquisitionWorker(neureset, REFRESH_PERIOD);
     refresh = new QTimer(this);
     connect(refresh, SIGNAL(timeout()), this, SLOT(updateBrainState()));
 
@@ -166,10 +167,6 @@ void MainWindow::loader() {
     //red light timer
     redLight = new QTimer(this);
     connect(redLight, SIGNAL(timeout()), this, SLOT(flashRed()));
-    //the timer to record 5 minutes
-    fiveMinutes = new QTimer(this);
-    fiveMinutes->setSingleShot(true);
-    connect(fiveMinutes, SIGNAL(timeout()), this, SLOT(fiveMinTimeOut()));
     ui->tab->setCurrentIndex(0);
 
     // system is assumped to start at full battery so no error on botton right
@@ -192,7 +189,12 @@ void MainWindow::loader() {
 */
 void MainWindow::batteryLife() {
 
-    ui->batteryProgress->setValue(ui->batteryProgress->value() - 1);
+    // one unit per second of clock time, however often the timer fires
+    const int drained = elapsedSeconds(batteryStamp);
+    if (drained == 0)
+        return;
+
+    ui->batteryProgress->setValue(std::max(0, ui->batteryProgress->value() - drained));
 
     if (ui->batteryProgress->value() <= BATTERY_CAPACITY * LOW_BATTERY_SHUTOFF) {
         battery->stop();
@@ -241,6 +243,7 @@ void MainWindow::siteChange() {
 void MainWindow::power() {
     isPower = !isPower;
     if (isPower) {
+        acquisition->start();
         refresh->start(REFRESH_PERIOD);
         ui->topBar->setVisible(true);
         ui->listWindow->setVisible(true);
@@ -258,14 +261,16 @@ void MainWindow::power() {
         ui->historyList->setCurrentRow(0);
 
         isPause = false;        // acts as initializer
-        battery->start(1000);   // battery start 1 second refresh
+        batteryStamp = clock.now();
+        battery->start(clock.interval(1000));   // battery start 1 second refresh
     } else {
         ui->topBar->setVisible(false);
         ui->listWindow->setVisible(false);
         isTreat = false;
         refresh->stop();        // stop updating screen
+        acquisition->stop();    // and producing frames
         battery->stop();        // stop battery timer
-        fiveMinutes->stop();    //stop the 5 mins timer if it is not attached
+        stopDisconnectTimer();  //stop the 5 mins timer if it is not attached
         redLight->stop();       //stop flashing red even if not attached
 
         ui->power->setChecked(false); //we need this to turn off the power light when battery dead
@@ -274,10 +279,9 @@ void MainWindow::power() {
 
 
         //stop the treatment if the device is poweroff when a treatment is running
-        if (future.isRunning()) {
+        if (treatmentSession >= 0) {
             treatmentTimer->stop();
             neureset->stopTreatment();
-            future.cancel();
             isTreat = false;
         }
         restart(); //clears a pause condition if exists
@@ -310,13 +314,12 @@ void MainWindow::restart() {
 
 // if running and want to stop
 void MainWindow::stopTreatment() {
-    if (future.isRunning()) {
+    if (treatmentSession >= 0) {
         treatmentTimer->stop();
         //if stop when not attached
-        fiveMinutes->stop();
+        stopDisconnectTimer();
         redLight->stop();
         neureset->stopTreatment();
-        future.cancel();
         isTreat = false;
         ui->treatmentTimer->setVisible(false);
         ui->sessionEnd->setVisible(true);
@@ -347,15 +350,15 @@ void MainWindow::attach(int state) {
             ui->blue->setStyleSheet("background-color: blue;");
 
             if (isPause){
-                fiveMinutes->stop();
+                stopDisconnectTimer();
             }
         }
     } else {
         isAttached = false;
         if (isInSession) {
-            fiveMinutes->start(300000);
+            startDisconnectTimer();
             ui->blue->setStyleSheet("background-color: rgb(246, 245, 244);");
-            redLight->start(500);
+            redLight->start(500);   // blink is for the eye, real time
             pause(); // is in session and disconnected pause.
         }
         neureset->setSite(-1);
@@ -371,68 +374,85 @@ void MainWindow::attach(int state) {
 */
 void MainWindow::treatment() {
 
-    if (!future.isRunning()) {
+    if (treatmentSession < 0) {
 
-        treatmentTimer->start(1000);
+        countdownStamp = clock.now();
+        treatmentTimer->start(clock.interval(1000));
         timeleft = TREATMENT_TIME;
         double preOverall = neureset->getOverallBaseline();
         QString currentTime;
 
         //save the current session to database
+        updateTime();
         currentTime = currentDateTime.toString("yyyy-MM-dd HH:mm:ss");
         dbManager->addSession(currentTime);
         isTreat = true;
         ui->siteSlider->setEnabled(false);
 
-        future = QtConcurrent::run([this, currentTime, preOverall]() {
+        treatmentSession = neureset->openSession();
+        runSession(treatmentSession, currentTime, preOverall).start(neureset->getScheduler(), treatmentSession);
+    }
+}
+
+/*
+    All sites in turn, one neureset session. Runs on the protocol scheduler thread, widgets are
+    only touched through queued calls. Stop closes the session and it returns from its current
+    wait.
+*/
+ProtocolTask MainWindow::runSession(const int id, const QString currentTime, const double preOverall) {
+    ProtocolScheduler& scheduler = neureset->getScheduler();
 
-            double preTreat;
-            double postTreat;
-            for (int i = 0; i < NUM_BRAIN_SITES; ++i) {
+    double preTreat;
+    double postTreat;
+    for (int i = 0; i < NUM_BRAIN_SITES; ++i) {
 
-                if (!isTreat) // end treatment
-                    break;
+        if (!scheduler.isOpen(id)) // end treatment
+            break;
 
-                ui->siteSlider->setValue(i);
-                site = ui->siteSlider->value();
-                ui->siteLabel->setText(QString::number(site));
+        QMetaObject::invokeMethod(this, [this, i]() {
+            ui->siteSlider->setValue(i);
+            site = ui->siteSlider->value();
+            ui->siteLabel->setText(QString::number(site));
+        }, Qt::QueuedConnection);
 
-                // new site, get next treatment location
-                neureset->setSite(site);
+        // new site, get next treatment location
+        neureset->setSite(i);
 
-                // peakFreq is automatically updated, no need to call geter
-                // preTreat = neureset->getDomFreq();
-                preTreat = peakFreq;
+        // setSite ran the analysis, peak is current
+        preTreat = neureset->getDomFreq();
 
-                neureset->treatment(); // complete round 4 shots, 1 site
+        // band powers of the untreated spectrum
+        db->addBandPowers(i + 1, neureset->getBandPowers(i), currentTime);
 
-                // postTreat = neureset->getDomFreq();
-                postTreat = peakFreq;
+        co_await neureset->treatSite(id); // complete round 4 shots, 1 site
 
-                //add the pre treatment dominant frequenccy to database
-                db->addBaseline(i + 1, preTreat, postTreat, currentTime);
-            }
+        postTreat = neureset->getDomFreq();
 
-            // finished
-            QMetaObject::invokeMethod(this, [this, currentTime, preOverall]() {
-                // if stopped when red light is on, clear red
-                redLight->stop();
-                ui->red->setStyleSheet("background-color: rgb(246, 245, 244);");
-                ui->treatmentTimer->setVisible(false);
-                if (isTreat)
-                    ui->sessionEnd->setVisible(true);
-                isTreat = false;
-                double postOverall = neureset->getOverallBaseline();
-                if (!isAttached)
-                    neureset->setSite(-1);
-                db->addBaseline(-1, preOverall, postOverall, currentTime);
-                ui->siteSlider->setValue(neureset->getSite());
-                ui->siteSlider->setEnabled(true);
-                isInSession = false;
-
-            }, Qt::QueuedConnection);
-        });
+        //add the pre treatment dominant frequenccy to database
+        db->addBaseline(i + 1, preTreat, postTreat, currentTime);
     }
+
+    neureset->closeSession(id);
+
+    // finished
+    QMetaObject::invokeMethod(this, [this, currentTime, preOverall]() {
+        // if stopped when red light is on, clear red
+        redLight->stop();
+        ui->red->setStyleSheet("background-color: rgb(246, 245, 244);");
+        ui->treatmentTimer->setVisible(false);
+        if (isTreat)
+            ui->sessionEnd->setVisible(true);
+        isTreat = false;
+        double postOverall = neureset->getOverallBaseline();
+        if (!isAttached)
+            neureset->setSite(-1);
+        db->addBaseline(-1, preOverall, postOverall, currentTime);
+        ui->siteSlider->setValue(neureset->getSite());
+        ui->siteSlider->setEnabled(true);
+        isInSession = false;
+        treatmentSession = -1;
+
+    }, Qt::QueuedConnection);
 }
 
 
@@ -448,37 +468,39 @@ void MainWindow::updateBrainState() {
 
     isRunning = true;
 
-    // protects from data being read and modified at same time
-    if (mtx.try_lock()) {
+    // newest complete frame from the acquisition worker, drawn without holding the device
+    const BrainSnapshot& snapshot = neureset->getSnapshot();
 
-        neureset->generator();
-
-        // freq
-        plotFreq->graph(0)->setData(domainTime, ampTime);  // needs to be QVector<double>, QVector<double>
-        plotFreq->rescaleAxes();
-        plotFreq->replot(QCustomPlot::rpQueuedReplot);
+    // nothing new since the last repaint
+    if (snapshot.frame == lastFrame) {
+        isRunning = false;
+        return;
+    }
+    lastFrame = snapshot.frame;
 
-        // dft
-        plotDft->graph(0)->setData(domainDFT, ampDFT);
-        plotDft->rescaleAxes();
-        plotDft->replot(QCustomPlot::rpQueuedReplot);
+    // freq
+    plotFreq->graph(0)->setData(domainTime, snapshot.ampTime);  // needs to be QVector<double>, QVector<double>
+    plotFreq->rescaleAxes();
+    plotFreq->replot(QCustomPlot::rpQueuedReplot);
 
-        //--------------------------------------------------------------------------------------//
+    // dft
+    plotDft->graph(0)->setData(domainDFT, snapshot.ampDFT);
+    plotDft->rescaleAxes();
+    plotDft->replot(QCustomPlot::rpQueuedReplot);
 
-        ui->maxFreq->setText(QString::number(peakFreq));
-        ui->maxFreqAmp->setText(QString::number(peakFreqAmp));
+    //--------------------------------------------------------------------------------------//
 
-        //--------------------------------------------------------------------------------------//
+    ui->maxFreq->setText(QString::number(snapshot.peakFreq));
+    ui->maxFreqAmp->setText(QString::number(snapshot.peakFreqAmp));
 
-        ui->progressBar->setValue(100 * progress / (NUM_OFFSETS * NUM_BRAIN_SITES));
+    //--------------------------------------------------------------------------------------//
 
-        if (treatAmp > 0.)
-            flashGreen();
-        else
-            ui->green->setStyleSheet("background-color: rgb(246, 245, 244);");
+    ui->progressBar->setValue(100 * snapshot.progress / (NUM_OFFSETS * NUM_BRAIN_SITES));
 
-        mtx.unlock();
-    }
+    if (snapshot.treatAmp > 0.)
+        flashGreen();
+    else
+        ui->green->setStyleSheet("background-color: rgb(246, 245, 244);");
 
     isRunning = false;
 }
@@ -639,8 +661,35 @@ void MainWindow::flashRed() {
     isRedOn = !isRedOn;
 }
 
+/*
+    Contact timeout, fiveMinTimeOut after DISCONNECT_TIMEOUT of clock time. A deadline on the
+    protocol scheduler rather than a QTimer, so a simulated clock gets to it the same way it
+    gets to the protocol's own steps.
+*/
+void MainWindow::startDisconnectTimer() {
+    stopDisconnectTimer();
+
+    ProtocolScheduler& scheduler = neureset->getScheduler();
+    const int id = disconnectSession = scheduler.open();
+
+    scheduler.schedule(id, DISCONNECT_TIMEOUT, [this, id]() {
+        QMetaObject::invokeMethod(this, [this, id]() {
+            if (id == disconnectSession) // not stopped while queued
+                fiveMinTimeOut();
+        }, Qt::QueuedConnection);
+    });
+}
+
+void MainWindow::stopDisconnectTimer() {
+    if (disconnectSession >= 0) {
+        neureset->getScheduler().close(disconnectSession);
+        disconnectSession = -1;
+    }
+}
+
 // Turns the device off after 5 minutes of disconnection
 void MainWindow::fiveMinTimeOut() {
+    stopDisconnectTimer();
     redLight->stop();
     ui->red->setStyleSheet("background-color: rgb(246, 245, 244);");
     power();
@@ -649,16 +698,33 @@ void MainWindow::fiveMinTimeOut() {
 // This function name is intentional (Qt wants it!!!)
 void MainWindow::on_dateTimeEdit_dateTimeChanged(const QDateTime &dateTime) {
     currentDateTime = dateTime;
+    dateSet = clock.now();
 }
 
+// brings the device date up to the clock, whole ms, the rest carries over
 void MainWindow::updateTime() {
-    currentDateTime = currentDateTime.addSecs(1);
+    const std::chrono::milliseconds elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(clock.now() - dateSet);
+    currentDateTime = currentDateTime.addMSecs(elapsed.count());
+    dateSet += elapsed;
 }
 
-// countdown time on treatment
+// whole seconds of clock time since stamp, the stamp moves up by them and keeps the rest
+int MainWindow::elapsedSeconds(Clock::time_point& stamp) const {
+    const std::chrono::seconds elapsed = std::chrono::duration_cast<std::chrono::seconds>(clock.now() - stamp);
+    stamp += elapsed;
+    return static_cast<int>(elapsed.count());
+}
+
+// countdown time on treatment, in clock seconds, paused time does not count
 void MainWindow::timerUpdate() {
-    if (!isPause) {
-        timeleft--;
+    if (isPause) {
+        countdownStamp = clock.now();
+        return;
+    }
+
+    const int seconds = elapsedSeconds(countdownStamp);
+    if (seconds > 0) {
+        timeleft = std::max(0, timeleft - seconds);
         calculateTime(timeleft);
 
         if (timeleft <= 0) {
@@ -679,6 +745,7 @@ void MainWindow::calculateTime(int time) {
 
 //SAVE THE date and time to database when program is off
 void MainWindow::closeEvent(QCloseEvent *event) {
+    updateTime();
     QString currentTime = currentDateTime.toString("yyyy-MM-dd HH:mm:ss");
     dbManager->updateDate(currentTime);
 }
@@ -5,14 +5,15 @@
 #include <QMainWindow>
 #include <QTimer>
 #include <QProgressBar>
-#include <QtConcurrent/QtConcurrent>
 #include <QDebug>
 #include <QDateTime>
 #include <QString>
 
 #include "defs.h"
+#include "clock.h"
 #include "qcustomplot.h" // import, not our work
 #include "neureset.h"
+#include "acquisitionworker.h"
 #include "agent.h"
 #include "databasemanager.h"
 
@@ -36,19 +37,12 @@ class MainWindow : public QMainWindow{
 
         Neureset* const neureset;
         Agent* agent;
+        Clock& clock;                   // device time, timers and dates run on it
 
-        // called once.
+        // called once. axes never change, the rest comes from neureset->getSnapshot()
         const QVector<double>& domainTime;
-        const QVector<double>& ampTime;
-
         const QVector<double>& domainDFT;
-        const QVector<double>& ampDFT;
-
-        const double& peakFreq;
-        const double& peakFreqAmp;
-        const int& progress;
-        const double& treatAmp;
-        std::mutex& mtx;
+        long long lastFrame;            // snapshot on screen
 
         int site;
         bool isAttached;
@@ -59,6 +53,9 @@ class MainWindow : public QMainWindow{
         bool isPower;
 
         QDateTime currentDateTime;
+        Clock::time_point dateSet;      // clock time currentDateTime is up to
+        Clock::time_point batteryStamp; // clock time drained up to
+        Clock::time_point countdownStamp; // clock time the countdown is up to
 
         //--------------------------------------------------------------------------------------//
 
@@ -66,12 +63,13 @@ class MainWindow : public QMainWindow{
         bool isPause;
         int timeleft;
 
-        QFuture<void> future;
-        QTimer* refresh;
+        int treatmentSession;           // neureset session of the running treatment, -1 when idle
+        AcquisitionWorker* acquisition; // frames off the gui thread
+        QTimer* refresh;                // repaint only
         QTimer* battery;
         QTimer* redLight;
 
-        QTimer* fiveMinutes;
+        int disconnectSession;          // scheduler session of the contact timeout, -1 when off
         QTimer* deviceClock;
         QTimer* treatmentTimer;
 
@@ -84,7 +82,11 @@ class MainWindow : public QMainWindow{
         void loader();
         void menuInit();
         void treatment();
+        ProtocolTask runSession(const int id, const QString currentTime, const double preOverall);
         void calculateTime(int time);
+        int elapsedSeconds(Clock::time_point& stamp) const;
+        void startDisconnectTimer();
+        void stopDisconnectTimer();
 
     private slots:
         void power();
@@ -0,0 +1,112 @@
+#include "matrix.h"
+
+#include <algorithm>
+
+
+template <typename T>
+Matrix<T>::Matrix() : data(nullptr), rows(0), cols(0), stride(0) {}
+
+template <typename T>
+Matrix<T>::Matrix(const int rows, const int cols, const bool packed) :
+        data(nullptr), rows(std::max(0, rows)), cols(std::max(0, cols)) {
+    // round the row up to whole MATRIX_ALIGN blocks
+    const int lane = MATRIX_ALIGN / static_cast<int>(sizeof(T));
+    stride = packed ? this->cols : (this->cols + lane - 1) / lane * lane;
+
+    const std::size_t count = static_cast<std::size_t>(this->rows) * stride;
+    if (count == 0)
+        return;
+
+    data = static_cast<T*>(::operator new[](count * sizeof(T), std::align_val_t(MATRIX_ALIGN)));
+    std::fill(data, data + count, T(0));
+}
+
+template <typename T>
+Matrix<T>::~Matrix() {
+    release();
+}
+
+template <typename T>
+void Matrix<T>::release() {
+    if (data)
+        ::operator delete[](data, std::align_val_t(MATRIX_ALIGN));
+    data = nullptr;
+}
+
+
+template <typename T>
+Matrix<T>::Matrix(Matrix&& other) noexcept : data(other.data), rows(other.rows), cols(other.cols),
+                                              stride(other.stride) {
+    other.data = nullptr;
+    other.rows = other.cols = other.stride = 0;
+}
+
+template <typename T>
+Matrix<T>& Matrix<T>::operator=(Matrix&& other) noexcept {
+    if (this != &other) {
+        release();
+
+        data = other.data;
+        rows = other.rows;
+        cols = other.cols;
+        stride = other.stride;
+
+        other.data = nullptr;
+        other.rows = other.cols = other.stride = 0;
+    }
+
+    return *this;
+}
+
+
+/*
+    Every element, padding included.
+*/
+template <typename T>
+void Matrix<T>::fill(const T value) {
+    std::fill(data, data + static_cast<std::size_t>(rows) * stride, value);
+}
+
+template <typename T>
+MatrixView<T> Matrix<T>::view() {
+    return {data, rows, cols, stride};
+}
+
+template <typename T>
+MatrixView<const T> Matrix<T>::view() const {
+    return {data, rows, cols, stride};
+}
+
+template <typename T>
+T* Matrix<T>::getData() {
+    return data;
+}
+
+template <typename T>
+const T* Matrix<T>::getData() const {
+    return data;
+}
+
+template <typename T>
+int Matrix<T>::getRows() const {
+    return rows;
+}
+
+template <typename T>
+int Matrix<T>::getCols() const {
+    return cols;
+}
+
+template <typename T>
+int Matrix<T>::getStride() const {
+    return stride;
+}
+
+template <typename T>
+bool Matrix<T>::isEmpty() const {
+    return data == nullptr;
+}
+
+
+template class Matrix<float>;
+template class Matrix<double>;
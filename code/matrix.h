@@ -0,0 +1,109 @@
+#ifndef MATRIX_H
+#define MATRIX_H
+
+#include <cstddef>
+#include <new>
+
+#include "defs.h"
+
+// bytes, every row starts on a cache line and on an avx-512 register boundary
+#define MATRIX_ALIGN 64
+
+
+/*
+    Window onto rows of a Matrix, or any row-major block with a stride, no copy.
+
+    const T for read only access. Valid while the matrix is alive and not reassigned.
+*/
+template <typename T>
+struct MatrixView {
+    T* data;
+    int rows;
+    int cols;
+    int stride;     // elements between row starts, >= cols
+
+    T* row(const int i) const {
+        return data + static_cast<std::ptrdiff_t>(i) * stride;
+    }
+
+    T* operator[](const int i) const {
+        return row(i);
+    }
+
+    // rows [first, first + count)
+    MatrixView<T> slice(const int first, const int count) const {
+        return {row(first), count, cols, stride};
+    }
+};
+
+
+/*
+    Row-major rows x cols buffer, one aligned allocation, zero initialized.
+
+    Rows are padded to a multiple of MATRIX_ALIGN bytes so every row is aligned and SIMD kernels
+    can take any row without peeling. packed drops the padding (stride == cols) for interleaved
+    blocks that must be contiguous across rows, only the first row is then aligned.
+
+    Movable, not copyable: moving hands over the allocation and leaves the source empty.
+
+    Instantiated for float and double.
+*/
+template <typename T>
+class Matrix {
+    private:
+        T* data;
+        int rows;
+        int cols;
+        int stride;
+
+        void release();
+
+    public:
+        Matrix();
+        Matrix(const int rows, const int cols, const bool packed = false);
+        ~Matrix();
+
+        Matrix(const Matrix&) = delete;
+        Matrix& operator=(const Matrix&) = delete;
+        Matrix(Matrix&& other) noexcept;
+        Matrix& operator=(Matrix&& other) noexcept;
+
+        void fill(const T value);
+
+        T* row(const int i);
+        const T* row(const int i) const;
+        T* operator[](const int i);
+        const T* operator[](const int i) const;
+
+        MatrixView<T> view();
+        MatrixView<const T> view() const;
+
+        T* getData();
+        const T* getData() const;
+        int getRows() const;
+        int getCols() const;
+        int getStride() const;
+        bool isEmpty() const;
+};
+
+
+template <typename T>
+inline T* Matrix<T>::row(const int i) {
+    return data + static_cast<std::ptrdiff_t>(i) * stride;
+}
+
+template <typename T>
+inline const T* Matrix<T>::row(const int i) const {
+    return data + static_cast<std::ptrdiff_t>(i) * stride;
+}
+
+template <typename T>
+inline T* Matrix<T>::operator[](const int i) {
+    return row(i);
+}
+
+template <typename T>
+inline const T* Matrix<T>::operator[](const int i) const {
+    return row(i);
+}
+#endif
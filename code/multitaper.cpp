@@ -0,0 +1,89 @@
+#include "multitaper.h"
+
+
+template <typename T>
+Multitaper<T>::Multitaper(const int size, const int length, const int bins, const double nw, const int count) :
+        size(size), bins(bins), count(count),
+        tapers(DpssTapers<T>::get(size, nw, count)),
+        engines(new SpectralEngine<T>*[count]),
+        tapered(new T[count * size]()), re(new T[count * bins]()), im(new T[count * bins]()),
+        spectrum(new double[bins]()) {
+
+    for (int k = 0; k < count; ++k)
+        engines[k] = SpectralEngine<T>::create(size, length, bins);
+}
+
+template <typename T>
+Multitaper<T>::~Multitaper() {
+    for (int k = 0; k < count; ++k)
+        delete engines[k];
+
+    delete[] engines;
+    delete[] tapered;
+    delete[] re;
+    delete[] im;
+    delete[] spectrum;
+}
+
+
+/*
+    Taper and transform the window once per taper, then average the eigenspectra.
+
+    Tapers are independent, workers take MULTITAPER_GRAIN worth of them each. Unscaled like
+    SpectralEngine.
+*/
+template <typename T>
+void Multitaper<T>::transform(const T* in) {
+    const int size = this->size;
+    const int bins = this->bins;
+
+    const int grain = std::max(1, MULTITAPER_GRAIN / std::max(1, size * bins));
+
+    parallelFor(0, count, grain, [this, in, size, bins](const int first, const int last) {
+        for (int k = first; k < last; ++k) {
+            const T* taper = tapers->getTaper(k);
+            T* const out = tapered + k * size;
+
+            for (int n = 0; n < size; ++n)
+                out[n] = in[n] * taper[n];
+
+            engines[k]->transform(out, re + k * bins, im + k * bins);
+        }
+    });
+
+    for (int b = 0; b < bins; ++b) {
+        double power = 0.;
+
+        for (int k = 0; k < count; ++k)
+            power += static_cast<double>(re[k * bins + b]) * re[k * bins + b]
+                   + static_cast<double>(im[k * bins + b]) * im[k * bins + b];
+
+        spectrum[b] = power / count;
+    }
+}
+
+
+// averaged eigenspectra per bin
+template <typename T>
+const double* Multitaper<T>::getSpectrum() const {
+    return spectrum;
+}
+
+template <typename T>
+int Multitaper<T>::getBins() const {
+    return bins;
+}
+
+template <typename T>
+int Multitaper<T>::getCount() const {
+    return count;
+}
+
+template <typename T>
+double Multitaper<T>::getNW() const {
+    return tapers->getNW();
+}
+
+
+template class Multitaper<float>;
+template class Multitaper<double>;
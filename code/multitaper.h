@@ -0,0 +1,52 @@
+#ifndef MULTITAPER_H
+#define MULTITAPER_H
+
+#include <memory>
+
+#include "defs.h"
+#include "dpss.h"
+#include "parallel.h"
+#include "spectralengine.h"
+
+// taper multiply-adds (size x bins) per worker before tapers are split across cores,
+// waking a pool worker costs about as much as a few small tapers, so device sized windows stay serial
+#define MULTITAPER_GRAIN 524288
+
+
+/*
+    Multitaper (Thomson) spectrum.
+
+    The window is tapered by each of count DPSS sequences with half bandwidth nw / size,
+    each taper transformed with its own engine (split across cores only for large shapes),
+    and the eigenspectra |X_k|^2 averaged with equal weights. Lower variance than a single
+    window at the cost of 2 nw / size resolution.
+
+    Tapers are unit energy and shared per configuration through DpssTapers.
+*/
+template <typename T>
+class Multitaper {
+    private:
+        const int size;
+        const int bins;
+        const int count;
+
+        const std::shared_ptr<const DpssTapers<T>> tapers;
+        SpectralEngine<T>** const engines; // one per taper, per worker
+
+        T* const tapered;                  // count x size
+        T* const re;                       // count x bins
+        T* const im;
+        double* const spectrum;            // mean |X_k|^2
+
+    public:
+        Multitaper(const int size, const int length, const int bins, const double nw, const int count);
+        ~Multitaper();
+
+        void transform(const T* in);
+
+        const double* getSpectrum() const;
+        int getBins() const;
+        int getCount() const;
+        double getNW() const;
+};
+#endif
@@ -9,33 +9,89 @@ Neureset::Neureset() : samplingRate(MAX_FREQ * MAX_SAMPLES), samplingRateDiv2(sa
                        domainTime(linspace(0, 1, samplingRate)), ampTime(samplingRate, 0.),
 
                        domainDFT(linspace(0, MAX_FREQ, samplingRateDiv2)), ampDFT(samplingRateDiv2, 0.),
+                       magDFT(samplingRateDiv2, 0.), phaseDFT(samplingRateDiv2, 0.), powerDFT(samplingRateDiv2, 0.),
 
                        treat(false), isPause(false),
 
                        treatAmp(0.), treatFreq(0.), progress(0),
 
-                       dft(constructDFT()), real(new double[samplingRateDiv2]()),
-                    //    imag(new double[samplingRateDiv2]()),
+                       scheduler(new ProtocolScheduler(Clock::getInstance())), session(-1),
 
-                       gen(rd()), dis(-maxNoise, maxNoise) {
+                       // zero padded to twice the window: bins land on every half hz
+                       engine(SpectralEngine<sample_t>::create(samplingRate, 2 * samplingRate, samplingRateDiv2)),
+                       input(new sample_t[samplingRate]()),
+                       real(new sample_t[samplingRateDiv2]()), imag(new sample_t[samplingRateDiv2]()),
+
+                       filters(new FilterChain<sample_t>(NUM_BRAIN_SITES)),
+
+                       streaming(false), primed(false),
+                       sliding(new SlidingDFT<sample_t>(samplingRate, 2 * samplingRate, samplingRateDiv2)),
+                       block(new sample_t[samplingRate]()), streamPos(0), refreshes(0),
+                       refreshPeriod(REFRESH_PERIOD),
+
+                       external(false), resampler(nullptr),
+
+                       batchTime(NUM_BRAIN_SITES, samplingRate),
+                       batchFrames(samplingRate, NUM_BRAIN_SITES, true),
+                       batchReal(NUM_BRAIN_SITES, samplingRateDiv2), batchImag(NUM_BRAIN_SITES, samplingRateDiv2),
+                       batchAmp(NUM_BRAIN_SITES, samplingRateDiv2), batchMag(NUM_BRAIN_SITES, samplingRateDiv2),
+
+                       welch(nullptr), psdDFT(samplingRateDiv2, 0.), psdPeakFreq(0.),
+
+                       multitaper(nullptr), mtDFT(samplingRateDiv2, 0.),
+
+                       zoom(nullptr), zoomReal(nullptr), zoomImag(nullptr),
+
+                       bands(new BandPowers(NUM_BRAIN_SITES, samplingRateDiv2, domainDFT.constData())),
+
+                       spectrogram(new Spectrogram(NUM_BRAIN_SITES, SPECTROGRAM_DEPTH, samplingRateDiv2)),
+
+                       noise(new NoiseGenerator(NUM_BRAIN_SITES, std::random_device()())),
+                       noiseType(NoiseGenerator::UNIFORM),
+
+                       snapshots(BrainSnapshot{QVector<double>(samplingRate, 0.), QVector<double>(samplingRateDiv2, 0.),
+                                               0., 0., 0., 0, -1, 0}),
+                       published(0) {
 
     std::cout << "Sampling Rate: " << samplingRate << std::endl;
     std::cout << "Max Frequency: " << MAX_FREQ << std::endl;
     std::cout << "Max Samples: " << MAX_SAMPLES << std::endl;
+    std::cout << "SIMD: " << SimdKernels::getName(SimdKernels::getLevel()) << std::endl;
 
     site = -1;
+    peakMethod = PeakRefiner::JACOBSEN;
+
+    // default front end, drift and mains out ahead of the spectrum
+    filters->add(Biquad<sample_t>::highpass(NUM_BRAIN_SITES, samplingRate, FILTER_HIGHPASS, FILTER_Q));
+    filters->add(Biquad<sample_t>::notch(NUM_BRAIN_SITES, samplingRate, FILTER_NOTCH, FILTER_NOTCH_Q));
+    filters->add(Biquad<sample_t>::lowpass(NUM_BRAIN_SITES, samplingRate, FILTER_LOWPASS, FILTER_Q));
 }
 
 // Destructor
 Neureset::~Neureset() {
     stopTreatment();
+    delete scheduler; // joins, no step runs past here
 
-    for (int i = 0; i < samplingRate; ++i)
-        delete[] dft[i];
-    delete[] dft;
+    delete engine;
 
+    delete[] input;
     delete[] real;
-    // delete[] imag;
+    delete[] imag;
+
+    delete filters;
+
+    delete sliding;
+    delete[] block;
+    delete resampler;
+
+    delete noise;
+    delete welch;
+    delete multitaper;
+    delete zoom;
+    delete[] zoomReal;
+    delete[] zoomImag;
+    delete bands;
+    delete spectrogram;
 }
 
 
@@ -45,11 +101,20 @@ Neureset::~Neureset() {
     Used for frequency and time domains.
 
     Used in plots.
+
+    Default axes come from DspTables, built at compile time.
 */
 QVector<double> Neureset::linspace(const int start, const int end, const int num_points) {
     QVector<double> vec;
     vec.resize(num_points);
 
+    const double* table = DspTables::axis(start, end, num_points);
+    if (table) {
+        for (int i = 0; i < num_points; ++i)
+            vec[i] = table[i];
+        return vec;
+    }
+
     const double step = static_cast<double>(end - start) / num_points;
 
     for (int i = 0; i < num_points; ++i)
@@ -60,45 +125,324 @@ QVector<double> Neureset::linspace(const int start, const int end, const int num
 
 
 /*
-    Construct a partial DFT matrix - reduces unnecessary recalculations.
+    Helmet is attached.
+
+    Controlled from Agent.
+*/
+void Neureset::helmet(Matrix<double>* brain) {
+    mtx.lock();
+    this->brain = brain;
+    mtx.unlock();
+}
+
+
+/*
+    Swap the time to frequency transform, takes ownership.
+
+    Engine must map samplingRate samples to samplingRateDiv2 half hz bins.
+*/
+void Neureset::setSpectralEngine(SpectralEngine<sample_t>* engine) {
+    mtx.lock();
+    delete this->engine;
+    this->engine = engine;
+    mtx.unlock();
+}
+
+
+/*
+    Append a filter stage ahead of the spectrum, takes ownership.
+
+    Stages are built for NUM_BRAIN_SITES channels, e.g.
+        Biquad<sample_t>::notch(NUM_BRAIN_SITES, rate, 50., 30.)
+    anything else is rejected and deleted. State is per site and carries across
+    refreshes in streaming mode.
+
+    The chain starts with highpass, notch and lowpass at the FILTER_ defaults, clearFilters
+    empties it. API only past that.
+*/
+bool Neureset::addFilter(FilterStage<sample_t>* stage) {
+    mtx.lock();
+    const bool added = filters->add(stage);
+    filters->reset();
+    primed = false; // refill the window through the new chain
+    mtx.unlock();
+
+    return added;
+}
+
+void Neureset::clearFilters() {
+    mtx.lock();
+    filters->clear();
+    primed = false;
+    mtx.unlock();
+}
+
+
+/*
+    Streaming mode - each refresh adds one refresh period of new samples (~13)
+    and updates the spectrum incrementally instead of recomputing the window.
+
+    API only, no UI control yet. Off by default, frames are recomputed whole.
+*/
+void Neureset::setStreaming(const bool streaming) {
+    mtx.lock();
+    this->streaming = streaming;
+    primed = false;
+    mtx.unlock();
+}
+
+bool Neureset::isStreaming() const {
+    return streaming;
+}
+
+
+/*
+    Cadence the generator is driven at, ms. Streaming appends this much signal per refresh.
+
+    Controlled from AcquisitionWorker.
+*/
+void Neureset::setRefreshPeriod(const int period) {
+    mtx.lock();
+    refreshPeriod = std::max(1, period);
+    refreshes = 0; // restart the carried remainder at the new period
+    mtx.unlock();
+}
+
+int Neureset::getRefreshPeriod() const {
+    return refreshPeriod;
+}
+
+
+/*
+    External acquisition - samples arrive through push at rate hz instead of the simulator.
 
-    Partial transformation matrix mapping time to frequency domains.
+    Input is decimated / resampled to samplingRate by a polyphase Resampler, so the window,
+    the spectrum length and domainDFT stay as they are. Streams into the sliding window,
+    which starts empty. A rate <= 0 is rejected and leaves the input as it was.
+
+    API only, for an external acquisition source, off until set.
 
     returns:
-        2D matrix
+        whether the rate was taken
 */
-double** Neureset::constructDFT() {
-    double** dftMatrix = new double* [samplingRate];
+bool Neureset::setInputRate(const int rate) {
+    if (rate <= 0)
+        return false;
+
+    mtx.lock();
+    delete resampler;
+    resampler = rate != samplingRate ? new Resampler<sample_t>(rate, samplingRate) : nullptr;
+
     for (int i = 0; i < samplingRate; ++i)
-        dftMatrix[i] = new double[samplingRateDiv2]();
+        block[i] = 0;
+    sliding->reset(block);
+    filters->reset(site);
+    if (welch)
+        welch->reset();
+
+    external = true;
+    streaming = true;
+    primed = true;
+    mtx.unlock();
 
-    const double two_pi = 2. * PI;
-    const double factor = PI / samplingRate;
+    return true;
+}
 
-    for (int n = 0; n < samplingRate; ++n)
-        for (int k = 0; k < samplingRateDiv2; ++k) {
-            double angle = factor * k * n;
+void Neureset::clearInput() {
+    mtx.lock();
+    delete resampler;
+    resampler = nullptr;
+    external = false;
+    primed = false;
+    mtx.unlock();
+}
 
-            // [0, 2 * PI)
-            angle = fmod(angle, two_pi);
-            dftMatrix[n][k] = angle;
-        }
 
-    return dftMatrix;
+/*
+    count samples at the input rate, oldest first. Shown on the next refresh.
+
+    Ignored until setInputRate.
+*/
+void Neureset::push(const sample_t* samples, const int count) {
+    mtx.lock();
+    if (!external) {
+        mtx.unlock();
+        return;
+    }
+
+    int ready = count;
+    if (resampler) {
+        acquired.resize(resampler->getMaxOutput(count));
+        ready = resampler->process(samples, count, acquired.data());
+    } else {
+        acquired.assign(samples, samples + count);
+    }
+
+    filters->processChannel(site, acquired.data(), ready);
+    sliding->push(acquired.data(), ready);
+
+    if (welch)
+        welch->push(acquired.data(), ready);
+
+    mtx.unlock();
+}
+
+bool Neureset::isExternal() const {
+    return external;
 }
 
 
 /*
-    Helmet is attached.
+    Simulated noise shape, same power for every type.
 
-    Controlled from Agent.
+    API only, uniform by default.
 */
-void Neureset::helmet(double* const* const* brain) {
+void Neureset::setNoise(const NoiseGenerator::Type type) {
     mtx.lock();
-    this->brain = brain;
+    noiseType = type;
+    mtx.unlock();
+}
+
+/*
+    Reproducible runs - same seed, same noise on every site.
+
+    API only, seeded from std::random_device at construction.
+*/
+void Neureset::seedNoise(const uint64_t seed) {
+    mtx.lock();
+    noise->seed(seed);
+    mtx.unlock();
+}
+
+
+/*
+    Welch PSD alongside the live spectrum.
+
+    segment samples per taper (2 - samplingRate), overlap samples shared between segments
+    (0 - segment - 1), average segments in the running mean, out of range values are clamped.
+    Segments are cut from new samples as they arrive, the estimate settles without blocking.
+
+    API only, off until set. Read back through getPSD.
+*/
+void Neureset::setWelch(const Window::Type type, const int segment, const int overlap, const int average) {
+    mtx.lock();
+    delete welch;
+    const int length = std::min(std::max(2, segment), samplingRate);
+    const int shared = std::min(std::max(0, overlap), length - 1); // hop of at least one sample
+    welch = new WelchPSD<sample_t>(type, samplingRate, length, shared, 2 * samplingRate, samplingRateDiv2,
+                                   std::max(1, average));
+    psdDFT.fill(0.);
+    psdPeakFreq = 0.;
+    mtx.unlock();
+}
+
+void Neureset::clearWelch() {
+    mtx.lock();
+    delete welch;
+    welch = nullptr;
+    mtx.unlock();
+}
+
+
+/*
+    Multitaper peak in place of the single window peak.
+
+    tapers DPSS sequences of half bandwidth nw bins (of the unpadded window, 1 hz), typically
+    tapers = 2 nw - 1. Trades resolution for a steadier peak on low SNR sites. Out of range values
+    are clamped: nw to 0.5 - samplingRate / 2 - 1, tapers to 1 - 2 nw (past that the sequences
+    are no longer concentrated, and beyond samplingRate there are none).
+
+    API only, off until set. Live peak and site baselines both use it.
+*/
+void Neureset::setMultitaper(const double nw, const int tapers) {
+    const double half = std::min(std::max(nw, 0.5), samplingRate / 2. - 1.);
+    const int count = std::min(std::max(1, tapers), std::min(samplingRate, static_cast<int>(2. * half)));
+
+    mtx.lock();
+    delete multitaper;
+    multitaper = new Multitaper<sample_t>(samplingRate, 2 * samplingRate, samplingRateDiv2, half, count);
+    mtDFT.fill(0.);
+    mtx.unlock();
+}
+
+void Neureset::clearMultitaper() {
+    mtx.lock();
+    delete multitaper;
+    multitaper = nullptr;
+    mtx.unlock();
+}
+
+
+/*
+    Chirp-z zoom over [low, high) hz with points bins, alongside the live spectrum.
+
+    Fine resolution inside the treated band without a longer window or a full length transform.
+    With PeakRefiner::ZOOM selected and the spectrum peak inside the span, the peak is read
+    from the zoom instead.
+
+    Out of range values are clamped: the span to 0 - samplingRate / 2 (swapped if inverted, widened
+    to one window bin if empty), points to 2 - ZOOM_MAX_POINTS.
+
+    API only, off until set. Read back through getZoomDomain and getZoomDFT.
+*/
+void Neureset::setZoom(const double lowFreq, const double highFreq, const int points) {
+    double low = std::min(std::max(std::min(lowFreq, highFreq), 0.), static_cast<double>(samplingRateDiv2));
+    double high = std::min(std::max(std::max(lowFreq, highFreq), 0.), static_cast<double>(samplingRateDiv2));
+
+    if (!(high > low)) { // 1 hz bin around the point, inside the band
+        low = std::min(std::max(low - 0.5, 0.), samplingRateDiv2 - 1.);
+        high = low + 1.;
+    }
+
+    const int count = std::min(std::max(2, points), ZOOM_MAX_POINTS);
+
+    mtx.lock();
+    delete zoom;
+    delete[] zoomReal;
+    delete[] zoomImag;
+
+    zoom = new ChirpZ<sample_t>(samplingRate, samplingRate, low, high, count);
+    zoomReal = new sample_t[count]();
+    zoomImag = new sample_t[count]();
+
+    zoomDomain.resize(count);
+    zoomDFT.resize(count);
+    for (int k = 0; k < count; ++k) {
+        zoomDomain[k] = low + k * (high - low) / count;
+        zoomDFT[k] = 0.;
+    }
+    mtx.unlock();
+}
+
+void Neureset::clearZoom() {
+    mtx.lock();
+    delete zoom;
+    delete[] zoomReal;
+    delete[] zoomImag;
+    zoom = nullptr;
+    zoomReal = nullptr;
+    zoomImag = nullptr;
+    zoomDomain.resize(0);
+    zoomDFT.resize(0);
+    mtx.unlock();
+}
+
+
+/*
+    Sub-bin peak estimator, NONE reads the bin centre.
+
+    API only, default PeakRefiner::JACOBSEN until set.
+*/
+void Neureset::setPeakMethod(const PeakRefiner::Method method) {
+    mtx.lock();
+    peakMethod = method;
     mtx.unlock();
 }
 
+PeakRefiner::Method Neureset::getPeakMethod() const {
+    return peakMethod;
+}
+
 
 /*
     Select a row in brain.
@@ -108,6 +452,9 @@ void Neureset::helmet(double* const* const* brain) {
 void Neureset::setSite(const int site) {
     mtx.lock();
     this->site = site;
+    primed = false; // new signal, refill the window
+    if (welch)
+        welch->reset();
     generator();
     mtx.unlock();
 }
@@ -122,23 +469,127 @@ void Neureset::setSite(const int site) {
 */
 void Neureset::generator() {
 
-    for (int i = 0; i < samplingRate; ++i) {
-        // stops accumulation of values
-        // amps[i] = 0.; // if you dont want jitter
-        ampTime[i] = dis(gen);
+    if (external) {
+        // pushed samples already slid the window
+        const sample_t* window = sliding->getWindow();
+        for (int i = 0; i < samplingRate; ++i)
+            ampTime[i] = window[i];
+    } else if (streaming && primed) {
+        stream();
+    } else {
+        frame();
+    }
+
+    dftRunner();
+    publish();
+}
+
+
+/*
+    Hands the frame to the UI as one snapshot, the reader never sees it half written.
+
+    Called with mtx held, which keeps publishers one at a time.
+*/
+void Neureset::publish() {
+    BrainSnapshot& snapshot = snapshots.write();
+
+    std::copy(ampTime.constData(), ampTime.constData() + samplingRate, snapshot.ampTime.data());
+    std::copy(ampDFT.constData(), ampDFT.constData() + samplingRateDiv2, snapshot.ampDFT.data());
+    snapshot.peakFreq = peakFreq;
+    snapshot.peakFreqAmp = peakFreqAmp;
+    snapshot.treatAmp = treatAmp;
+    snapshot.progress = progress;
+    snapshot.site = site;
+    snapshot.frame = ++published;
+
+    snapshots.publish();
+}
 
-        // test frequency injection
-        // ampTime[i] += 1. * std::cos(2. * PI * 30 * domainTime[i]);
 
-        // signal - if valid in range from [0, 20]
-        if (site > -1 && site < NUM_BRAIN_SITES)
-            ampTime[i] += (*brain)[site][i];
+/*
+    count samples of the simulated signal of row, from absolute index first.
 
-        // treatment - visual only
-        ampTime[i] += treatAmp * std::cos(2. * PI * treatFreq * domainTime[i]);
+    Brain rows hold one second, repeated. Noise is drawn as one block from the row's own stream,
+    so rows can be synthesized on separate threads.
+*/
+void Neureset::synthesize(const int row, const long long first, const int count, sample_t* out) {
+    // stops accumulation of values
+    noise->fill(noiseType, std::max(0, row), out, count, maxNoise);
+
+    // test frequency injection
+    // Oscillator test(30, samplingRate); test.seek(first); test.accumulate(out, count, 1.);
+
+    // signal - if valid in range from [0, 20]
+    if (row > -1 && row < NUM_BRAIN_SITES)
+        for (int i = 0; i < count; ++i)
+            out[i] = static_cast<sample_t>(out[i] + (*brain)[row][(first + i) % samplingRate]);
+
+    // treatment - visual only
+    if (treatAmp != 0.) {
+        Oscillator tone(treatFreq, samplingRate);
+        tone.seek(first);
+        tone.accumulate(out, count, treatAmp);
     }
+}
 
-    dftRunner();
+
+/*
+    Regenerates the whole window.
+
+    In streaming mode this primes the sliding DFT.
+*/
+void Neureset::frame() {
+    synthesize(site, 0, samplingRate, input);
+
+    // whole window from rest, streaming carries the state on from here
+    if (!filters->isEmpty()) {
+        filters->reset(site);
+        filters->processChannel(site, input, samplingRate);
+    }
+
+    for (int i = 0; i < samplingRate; ++i)
+        ampTime[i] = input[i];
+
+    // a fresh window, not a continuation of the last one: segments start over within it
+    if (welch) {
+        welch->restart();
+        welch->push(input, samplingRate);
+    }
+
+    if (streaming) {
+        sliding->reset(input);
+        streamPos = samplingRate;
+        refreshes = 0;
+        primed = true;
+    }
+}
+
+
+/*
+    Appends the samples of one refresh period and slides the spectrum.
+
+    Refresh period does not divide the sampling rate evenly, the count is carried across refreshes.
+*/
+void Neureset::stream() {
+    const long long due = (refreshes + 1) * samplingRate * refreshPeriod / 1000
+                        - refreshes * samplingRate * refreshPeriod / 1000;
+    const int count = static_cast<int>(std::min<long long>(due, samplingRate));
+    ++refreshes;
+
+    synthesize(site, streamPos, count, block);
+    streamPos += count;
+
+    filters->processChannel(site, block, count);
+
+    sliding->push(block, count);
+
+    if (welch)
+        welch->push(block, count);
+
+    // oscilloscope shows the current window
+    const sample_t* window = sliding->getWindow();
+    for (int i = 0; i < samplingRate; ++i)
+        ampTime[i] = window[i];
 }
 
 
@@ -148,122 +599,291 @@ void Neureset::generator() {
     Finds peak and amplitude.
 */
 void Neureset::dftRunner() {
+    const bool slid = streaming || external; // spectrum and window live in sliding
 
-    for (int k = 0; k < samplingRateDiv2; ++k) { // each frequency bin
-        real[k] = 0.;
-        // imag[k] = 0.;
-
-        // complete rotatation matrix
-        for (int n = 0; n < samplingRate; ++n) {
-            angle = dft[n][k];
-            real[k] += ampTime[n] * cos(angle); // real component arbitrary cos
-            // imag[k] += ampTime[n] * sin(angle); // imaginary component (any phase shift relative to cos)
+    if (slid) {
+        const sample_t* slidingReal = sliding->getReal();
+        const sample_t* slidingImag = sliding->getImag();
+
+        for (int k = 0; k < samplingRateDiv2; ++k) {
+            real[k] = slidingReal[k];
+            imag[k] = slidingImag[k];
+        }
+    } else {
+        engine->transform(input, real, imag);
+    }
+
+    analyze(site, real, imag, ampDFT.data(), magDFT.data(), phaseDFT.data(), powerDFT.data(), maxIndex, maxValue);
+
+    // dft freq and amp here
+    peakFreq = estimatePeak(slid ? sliding->getWindow() : input, real, imag, magDFT.data(), maxIndex, peakFreqAmp);
+
+    spectrogram->push(site, magDFT.data());
+
+    if (welch && welch->getSegments() > 0) {
+        const double* psd = welch->getPSD();
+        int psdIndex = 0;
+
+        for (int k = 0; k < samplingRateDiv2; ++k) {
+            psdDFT[k] = psd[k];
+            if (psd[k] > psd[psdIndex])
+                psdIndex = k;
         }
 
+        psdPeakFreq = domainDFT[psdIndex];
+    }
+}
+
+
+/*
+    Scales raw bins, fills amplitudes, finds the strongest bin.
+
+    One pass over the bins: |real|, magnitude, phase and power together, band powers of
+    site row ride along. phase and power may be null (batched baseline).
+
+    Peak is the largest magnitude, independent of the phase of the signal.
+*/
+void Neureset::analyze(const int row, sample_t* re, sample_t* im, double* amp, double* mag, double* phase,
+                       double* power, int& index, double& value) {
+
+    index = 0;
+    value = 0.;
+    bands->begin(row);
+
+    for (int k = 0; k < samplingRateDiv2; ++k) { // each frequency bin
         // horizontal scaling
-        real[k] /= samplingRateDiv2;
-        // imag[i] /= samplingRateDiv2;
+        re[k] /= samplingRateDiv2;
+        im[k] /= samplingRateDiv2;
 
         // dft solution here
-        ampDFT[k] = std::abs(real[k]);
-        // ampDFT[i] = std::sqrt(real[i]*real[i] + imag[i]*imag[i]);
-    }
+        const double squared = static_cast<double>(re[k]) * re[k] + static_cast<double>(im[k]) * im[k];
+        amp[k] = std::abs(re[k]);
+        mag[k] = std::sqrt(squared);
 
-    maxIndex = 0;
-    maxValue = 0.;
+        if (phase)
+            phase[k] = std::atan2(im[k], re[k]);
+        if (power)
+            power[k] = squared;
 
-    // define max freq and its amplitude from dft
-    for (int i = 0; i < samplingRateDiv2; ++i)
-        if (ampDFT[i] > maxValue) {
-            maxValue = ampDFT[i];
-            maxIndex = i;
+        bands->accumulate(row, k, squared, mag[k]);
+
+        // define max freq and its amplitude from dft
+        if (mag[k] > value) {
+            value = mag[k];
+            index = k;
         }
+    }
+}
 
-    // dft freq and amp here
-    peakFreq = domainDFT[maxIndex];
-    peakFreqAmp = maxValue;
+
+/*
+    Peak frequency of bin index moved by the sub-bin offset, amp gets the interpolated height.
+
+    Bins are half hz apart from 2x zero padding, the refiner is told so.
+*/
+double Neureset::refinePeak(const sample_t* re, const sample_t* im, const double* mag, const int index,
+                            double& amp) const {
+    const double binWidth = static_cast<double>(MAX_FREQ) / samplingRateDiv2;
+    const int pad = engine->getLength() / samplingRate;
+
+    const double offset = PeakRefiner::refine(peakMethod, re, im, mag, samplingRateDiv2, index, pad, amp);
+
+    return domainDFT[index] + offset * binWidth;
 }
 
 
 /*
-    Calcualte local average dominant frequency.
+    Peak of one window by the active estimator, live spectrum and batch baselines alike:
+        window spectrum     bin index refined by peakMethod
+        multitaper (set)    replaces it with the multitaper peak
+        zoom (set)          replaces that with the zoom peak, PeakRefiner::ZOOM and inside the span
 
-    Not utilized in downstream calculations, cout only.
+    window is the time samples behind re / im / mag. Fills mtDFT and zoomDFT for display.
 
-    Controlled from UI.
+    returns:
+        peak freq, amp set
+*/
+double Neureset::estimatePeak(const sample_t* window, const sample_t* re, const sample_t* im, const double* mag,
+                              const int index, double& amp) {
+    double freq = refinePeak(re, im, mag, index, amp);
 
-    Blocking.
+    if (multitaper) {
+        multitaper->transform(window);
 
-    Initiates delay timer on green light - following customer requirements.
+        // amplitude as if from a unit energy rectangular window, comparable with magDFT
+        const double* spectrum = multitaper->getSpectrum();
+        int mtIndex = 0;
+
+        for (int k = 0; k < samplingRateDiv2; ++k) {
+            mtDFT[k] = std::sqrt(spectrum[k] * samplingRate) / samplingRateDiv2;
+            if (mtDFT[k] > mtDFT[mtIndex])
+                mtIndex = k;
+        }
+
+        // power only, jacobsen falls back to parabolic
+        freq = refinePeak(nullptr, nullptr, mtDFT.data(), mtIndex, amp);
+    }
+
+    if (zoom) {
+        zoom->transform(window, zoomReal, zoomImag);
+
+        const int points = zoom->getPoints();
+        int zoomIndex = 0;
+
+        for (int k = 0; k < points; ++k) {
+            zoomDFT[k] = std::sqrt(static_cast<double>(zoomReal[k]) * zoomReal[k]
+                                 + static_cast<double>(zoomImag[k]) * zoomImag[k]) / samplingRateDiv2;
+            if (zoomDFT[k] > zoomDFT[zoomIndex])
+                zoomIndex = k;
+        }
+
+        // zoom bins oversample the window resolution, parabolic is enough between them
+        if (peakMethod == PeakRefiner::ZOOM && freq >= zoom->getLow() && freq < zoom->getHigh()) {
+            double zoomAmp;
+            const double offset = PeakRefiner::refine<sample_t>(PeakRefiner::PARABOLIC, nullptr, nullptr,
+                                                                zoomDFT.constData(), points, zoomIndex, 1, zoomAmp);
+
+            freq = zoomDomain[zoomIndex] + offset * (zoom->getHigh() - zoom->getLow()) / points;
+            amp = zoomAmp;
+        }
+    }
+
+    return freq;
+}
+
+
+/*
+    Starts a treatment session, replacing any running one. Sites are treated within it by
+    awaiting treatSite, pause and stop act on the whole session.
+
+    returns:
+        session id
 */
-void Neureset::pretreatment() { // delay 1)
-    treat = true;
-    double localBaseline = 0.;
-    int loops = 5;
+int Neureset::openSession() {
+    mtx.lock();
+    if (session >= 0)
+        scheduler->close(session); // one protocol per device
 
-    for (int i = 0; i < loops; ++i) { // 5 x 1 second delay
-        if (!treat)
-            return;
+    const int id = session = scheduler->open();
+    treat = true;
+    if (isPause)
+        scheduler->pause(id);
+    mtx.unlock();
 
-        while (isPause) // user pauses treatment
-            std::this_thread::sleep_for(std::chrono::milliseconds(1000));
+    return id;
+}
 
-        localBaseline += peakFreq;
-        std::this_thread::sleep_for(std::chrono::milliseconds(1000));
+/*
+    Ends session id if it is still the running one, anything awaiting in it returns.
+*/
+void Neureset::closeSession(const int id) {
+    mtx.lock();
+    if (id >= 0 && id == session) {
+        scheduler->close(id);
+        session = -1;
+        treat = false;
+        treatAmp = 0.;
+        publish();
     }
-    localBaseline /= loops;
-    std::cout << " Pretreatment analysis local baseline: " << localBaseline << std::endl;
+    mtx.unlock();
 }
 
 
 /*
     Use DFT solved amplitude and frequency to determine artificial and real determine treatment.
 
-    Controlled from UI.
+    One site, awaited from a session coroutine:
+        5 x 1 s     pretreatment - local average dominant frequency, cout only
+        4 x         1 s delay, shot (peak + 5, 10, 15, 20 hz shown), 1 s showing it
+
+    Pause freezes the time left of the current step, stop (session closed) returns at the next
+    await. Runs on the scheduler thread.
 
-    Blocking.
+    Initiates delay timer on green light - following customer requirements.
 */
-void Neureset::treatment() {
+ProtocolTask Neureset::treatSite(const int id) {
+    double localBaseline = 0.;
+
+    for (int i = 0; i < PRETREATMENT_STEPS; ++i) { // delay 1) 5 x 1 second
+        mtx.lock();
+        localBaseline += peakFreq;
+        mtx.unlock();
 
-    pretreatment();
+        if (!co_await ProtocolSleep(*scheduler, id, TREATMENT_STEP))
+            co_return;
+    }
+    std::cout << " Pretreatment analysis local baseline: " << localBaseline / PRETREATMENT_STEPS << std::endl;
 
     for (int i = 1; i < NUM_OFFSETS + 1; ++i) { // 5 10 15 20 offset freq treatment
-        std::this_thread::sleep_for(std::chrono::milliseconds(1000)); // delay 2)
-
-        while (isPause) // user pauses treatment
-            std::this_thread::sleep_for(std::chrono::milliseconds(1000));
+        if (!co_await ProtocolSleep(*scheduler, id, TREATMENT_STEP)) // delay 2)
+            co_return;
 
         mtx.lock();
 
-        if (!treat) {
-            treatAmp = 0.;
-            mtx.unlock();
-            return;
-        }
-
         // artificial treatment - visual
         treatFreq = peakFreq + 5 * i;
         treatAmp = peakFreqAmp * 0.5;
 
         // actual treatment - not visual
-        for (int j = 0; j < samplingRate; ++j)
-            (*brain)[site][j] -= 0.2 * peakFreqAmp * std::cos(2. * PI * peakFreq * domainTime[j]);
+        Oscillator(peakFreq, samplingRate).accumulate((*brain)[site], samplingRate, -0.2 * peakFreqAmp);
 
         progress += 1;
         std::cout << progress << std::endl;
 
+        publish();
         mtx.unlock();
 
         // show treatment for 1 second
-        std::this_thread::sleep_for(std::chrono::milliseconds(1000)); // delay 3)
+        const bool shown = co_await ProtocolSleep(*scheduler, id, TREATMENT_STEP); // delay 3)
 
         mtx.lock();
         treatAmp = 0.;
+        publish();
         mtx.unlock();
 
+        if (!shown)
+            co_return;
     }
+}
 
-    treat = false;
+
+/*
+    One site in a session of its own. done(completed) runs on the scheduler thread when it
+    ends, false when stopped.
+
+    API only, the UI runs whole sessions through openSession / treatSite.
+*/
+void Neureset::beginTreatment(std::function<void(bool)> done) {
+    const int id = openSession();
+    runTreatment(id, std::move(done)).start(*scheduler, id);
+}
+
+ProtocolTask Neureset::runTreatment(const int id, std::function<void(bool)> done) {
+    co_await treatSite(id);
+
+    const bool completed = scheduler->isOpen(id);
+    closeSession(id);
+
+    if (done)
+        done(completed);
+}
+
+/*
+    Blocking form of beginTreatment, returns when the site is done or stopped.
+*/
+void Neureset::treatment() {
+    std::mutex finished;
+    std::condition_variable signal;
+    bool over = false;
+
+    beginTreatment([&finished, &signal, &over](bool) {
+        std::lock_guard<std::mutex> guard(finished);
+        over = true;
+        signal.notify_all();
+    });
+
+    std::unique_lock<std::mutex> guard(finished);
+    signal.wait(guard, [&over]() { return over; });
 }
 
 
@@ -289,14 +909,89 @@ const QVector<double>& Neureset::getAmpDFT() const {
 }
 
 
-// strongest freq
-const double& Neureset::getDomFreq() const {
-    return peakFreq;
+// complex spectrum
+const QVector<double>& Neureset::getMagDFT() const {
+    return magDFT;
+}
+
+const QVector<double>& Neureset::getPhaseDFT() const {
+    return phaseDFT;
+}
+
+const QVector<double>& Neureset::getPowerDFT() const {
+    return powerDFT;
+}
+
+// welch
+const QVector<double>& Neureset::getPSD() const {
+    return psdDFT;
+}
+
+const double& Neureset::getPSDPeakFreq() const {
+    return psdPeakFreq;
+}
+
+// multitaper
+const QVector<double>& Neureset::getMultitaperDFT() const {
+    return mtDFT;
+}
+
+// zoom
+const QVector<double>& Neureset::getZoomDomain() const {
+    return zoomDomain;
+}
+
+const QVector<double>& Neureset::getZoomDFT() const {
+    return zoomDFT;
+}
+
+// band powers of the last spectrum of a site, NUM_BRAIN_FREQ entries, copied under the lock
+QVector<BandStats> Neureset::getBandPowers(const int site) const {
+    QVector<BandStats> result(NUM_BRAIN_FREQ);
+    if (site < 0 || site >= NUM_BRAIN_SITES)
+        return result;
+
+    mtx.lock();
+    const BandStats* stats = bands->get(site);
+    for (int b = 0; b < NUM_BRAIN_FREQ; ++b)
+        result[b] = stats[b];
+    mtx.unlock();
+
+    return result;
+}
+
+/*
+    Time-frequency history of a site, zero copy.
+
+    Read while holding getMutex(), the next spectrum overwrites the oldest row.
+*/
+SpectrogramView Neureset::getSpectrogram(const int site) const {
+    return spectrogram->view(site);
+}
+
+void Neureset::clearSpectrogram() {
+    mtx.lock();
+    spectrogram->clear();
+    mtx.unlock();
+}
+
+
+// strongest freq, copied under the lock, the acquisition thread rewrites it every refresh
+double Neureset::getDomFreq() const {
+    mtx.lock();
+    const double freq = peakFreq;
+    mtx.unlock();
+
+    return freq;
 }
 
-// amplitude
-const double& Neureset::getPeakFreqAmp() const {
-    return peakFreqAmp;
+// amplitude, as getDomFreq
+double Neureset::getPeakFreqAmp() const {
+    mtx.lock();
+    const double amp = peakFreqAmp;
+    mtx.unlock();
+
+    return amp;
 }
 
 // progress bar
@@ -312,27 +1007,66 @@ const double& Neureset::getTreatAmp() const {
 //--------------------------------------------------------------------------------------//
 // control
 
+/*
+    Pause freezes the treatment on the spot, resume continues with the time the step had left.
+*/
 bool Neureset::togglePause() {
-    isPause = !isPause;
     mtx.lock();
+    isPause = !isPause;
     treatAmp = 0.;
+
+    if (session >= 0) {
+        if (isPause)
+            scheduler->pause(session);
+        else
+            scheduler->resume(session);
+    }
+
+    publish();
+    const bool paused = isPause;
     mtx.unlock();
-    return isPause;
+
+    return paused;
 }
 
 void Neureset::resetProgress() {
+    mtx.lock();
     progress = 0;
+    publish();
+    mtx.unlock();
 }
 
+/*
+    Ends a running treatment at once, its coroutines unwind on the scheduler thread.
+*/
 void Neureset::stopTreatment() {
+    mtx.lock();
     treat = false;
     treatAmp = 0;
+    if (session >= 0) {
+        scheduler->close(session);
+        session = -1;
+    }
+    publish();
+    mtx.unlock();
 }
 
 std::mutex& Neureset::getMutex() {
     return mtx;
 }
 
+// runs the treatment coroutines, shared with the session driver in MainWindow
+ProtocolScheduler& Neureset::getScheduler() {
+    return *scheduler;
+}
+
+/*
+    Newest published frame, never blocks. UI thread only, valid until its next call.
+*/
+const BrainSnapshot& Neureset::getSnapshot() {
+    return snapshots.read();
+}
+
 
 
 /*
@@ -346,12 +1080,85 @@ std::mutex& Neureset::getMutex() {
 double Neureset::getOverallBaseline() {
     double temp = 0.;
 
+    for (const SitePeak& peak : getSiteBaselines())
+        temp += peak.freq;
+
+    return temp / NUM_BRAIN_SITES;
+}
+
+
+/*
+    Dominant frequency and amplitude of every site from one snapshot.
+
+    Brain matrix plus noise as one NUM_BRAIN_SITES x samplingRate block,
+    transformed in a single batched pass across cores.
+
+    Leaves the last site selected, as stepping through setSite did.
+
+    returns:
+        per site peak freq and amp
+*/
+QVector<SitePeak> Neureset::getSiteBaselines() {
+    QVector<SitePeak> peaks(NUM_BRAIN_SITES);
+
+    mtx.lock();
+
+    // every site draws from its own noise stream, rows are independent
+    parallelFor(0, NUM_BRAIN_SITES, BATCH_GRAIN, [this](const int first, const int last) {
+        for (int i = first; i < last; ++i)
+            synthesize(i, 0, samplingRate, batchTime[i]);
+    });
+
+    // chain runs interleaved, every site in the same pass
+    if (!filters->isEmpty()) {
+        for (int i = 0; i < NUM_BRAIN_SITES; ++i)
+            for (int j = 0; j < samplingRate; ++j)
+                batchFrames[j][i] = batchTime[i][j];
+
+        filters->reset();
+        filters->process(batchFrames.getData(), samplingRate);
+
+        for (int i = 0; i < NUM_BRAIN_SITES; ++i)
+            for (int j = 0; j < samplingRate; ++j)
+                batchTime[i][j] = batchFrames[j][i];
+    }
+
+    engine->transformBatch(batchTime.getData(), NUM_BRAIN_SITES, batchTime.getStride(),
+                           batchReal.getData(), batchImag.getData(), batchReal.getStride());
+
     for (int i = 0; i < NUM_BRAIN_SITES; ++i) {
-        setSite(i);
-        temp += peakFreq;
+        int index;
+        double value;
+        analyze(i, batchReal[i], batchImag[i], batchAmp[i], batchMag[i], nullptr, nullptr, index, value);
+
+        // same estimator as the live peak, so baselines compare with pre / post treatment
+        peaks[i].freq = estimatePeak(batchTime[i], batchReal[i], batchImag[i], batchMag[i], index, peaks[i].amp);
+
+        spectrogram->push(i, batchMag[i]);
     }
 
-    return temp / NUM_BRAIN_SITES;
+    // last site stays on screen
+    site = NUM_BRAIN_SITES - 1;
+    primed = false;
+    for (int j = 0; j < samplingRate; ++j) {
+        ampTime[j] = batchTime[site][j];
+        input[j] = batchTime[site][j];
+    }
+    for (int k = 0; k < samplingRateDiv2; ++k) {
+        real[k] = batchReal[site][k];
+        imag[k] = batchImag[site][k];
+        ampDFT[k] = batchAmp[site][k];
+        magDFT[k] = batchMag[site][k];
+        phaseDFT[k] = std::atan2(imag[k], real[k]);
+        powerDFT[k] = magDFT[k] * magDFT[k];
+    }
+    peakFreq = peaks[site].freq;
+    peakFreqAmp = peaks[site].amp;
+    publish();
+
+    mtx.unlock();
+
+    return peaks;
 }
 
 
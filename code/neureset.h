@@ -1,6 +1,9 @@
 #ifndef NEURESET_H
 #define NEURESET_H
 
+#include <algorithm>
+#include <condition_variable>
+#include <functional>
 #include <iostream>
 #include <thread>
 #include <random>
@@ -8,6 +11,43 @@
 #include <mutex>
 
 #include "defs.h"
+#include "bandpowers.h"
+#include "chirpz.h"
+#include "dsptables.h"
+#include "filterchain.h"
+#include "matrix.h"
+#include "multitaper.h"
+#include "noisegenerator.h"
+#include "oscillator.h"
+#include "peakrefiner.h"
+#include "protocoltask.h"
+#include "resampler.h"
+#include "slidingdft.h"
+#include "spectrogram.h"
+#include "spectralengine.h"
+#include "triplebuffer.h"
+#include "welchpsd.h"
+
+
+// dominant frequency of one site
+struct SitePeak {
+    double freq;
+    double amp;
+};
+
+
+// everything the UI draws from one frame, published whole
+struct BrainSnapshot {
+    QVector<double> ampTime;
+    QVector<double> ampDFT;
+
+    double peakFreq;
+    double peakFreqAmp;
+    double treatAmp;
+    int progress;
+    int site;
+    long long frame;     // publishes since start
+};
 
 
 class Neureset {
@@ -24,7 +64,12 @@ class Neureset {
         // to UI
         // Spectrum analyzer
         const QVector<double> domainDFT;
-        QVector<double> ampDFT;
+        QVector<double> ampDFT;         // |real|
+
+        // complex spectrum, same bins
+        QVector<double> magDFT;         // |real + i imag|
+        QVector<double> phaseDFT;       // radians, cos reference
+        QVector<double> powerDFT;       // magnitude squared
 
         bool treat;
         bool isPause;
@@ -33,34 +78,98 @@ class Neureset {
         double treatFreq;
         int progress;
 
-        const double* const* const dft; // matrix of angles - a partial dft matrix - fixed values
-        double* const real;             // cos detects real
-        // double* const imag;          // can detects imaginary - phase shift (just in case)
-
-        std::random_device rd;
-        std::mt19937 gen;
-        std::uniform_real_distribution<double> dis;
+        // treatment protocol as coroutines on the scheduler thread
+        ProtocolScheduler* const scheduler;
+        int session;                    // -1 when no treatment is running
+
+        // spectral pipeline runs in sample_t, the UI side stays double
+        SpectralEngine<sample_t>* engine; // time to frequency
+        sample_t* const input;          // ampTime in pipeline precision
+        sample_t* const real;           // cos detects real
+        sample_t* const imag;           // sin detects imaginary - phase shift (just in case)
+
+        // notch / highpass / lowpass stages ahead of the spectrum, one channel per site, empty by default
+        FilterChain<sample_t>* const filters;
+
+        // streaming - new samples slide the window instead of regenerating it
+        bool streaming;
+        bool primed;                    // window filled for the current site
+        SlidingDFT<sample_t>* const sliding;
+        sample_t* const block;          // newest samples of one refresh
+        long long streamPos;            // samples since the stream started
+        long long refreshes;
+        int refreshPeriod;              // ms between generator calls, sets the samples per refresh
+
+        // external acquisition at its own rate, off until setInputRate
+        bool external;
+        Resampler<sample_t>* resampler; // null when the input already runs at samplingRate
+        std::vector<sample_t> acquired; // latest pushed block at samplingRate
+
+        // all sites at once - NUM_BRAIN_SITES x samplingRate block
+        Matrix<sample_t> batchTime;     // site x sample
+        Matrix<sample_t> batchFrames;   // batchTime interleaved for the filter chain, packed
+        Matrix<sample_t> batchReal;     // site x bin
+        Matrix<sample_t> batchImag;
+        Matrix<double> batchAmp;
+        Matrix<double> batchMag;
+
+        // averaged power spectral density, off until setWelch
+        WelchPSD<sample_t>* welch;
+        QVector<double> psdDFT;         // uv^2 / hz, same bins
+        double psdPeakFreq;
+
+        // dpss multitaper peak for noisy sites, off until setMultitaper
+        Multitaper<sample_t>* multitaper;
+        QVector<double> mtDFT;          // amplitude, same bins
+
+        // band limited high resolution spectrum, off until setZoom
+        ChirpZ<sample_t>* zoom;
+        sample_t* zoomReal;
+        sample_t* zoomImag;
+        QVector<double> zoomDomain;
+        QVector<double> zoomDFT;        // magnitude, scaled like magDFT
+
+        // delta, theta, alpha, beta per site, filled by analyze
+        BandPowers* const bands;
+
+        // magnitude history per site, one frame per spectrum
+        Spectrogram* const spectrogram;
+
+        // one stream per site, whole blocks per refresh
+        NoiseGenerator* const noise;
+        NoiseGenerator::Type noiseType;
 
         //--------------------------------------------------------------------------------------//
 
-        double* const* const* brain;
+        Matrix<double>* brain;
         int site;
 
-        std::mutex mtx;
-
-        double angle;
+        mutable std::mutex mtx;
 
         int maxIndex;
         double maxValue;
 
         double peakFreq;
         double peakFreqAmp;
+        PeakRefiner::Method peakMethod; // sub-bin interpolation of the argmax
+
+        // latest frame for the UI, written under mtx, read without it
+        TripleBuffer<BrainSnapshot> snapshots;
+        long long published;
 
         QVector<double> linspace(const int start, const int end, const int num_points);
 
-        double** constructDFT();
+        void synthesize(const int row, const long long first, const int count, sample_t* out);
+        void publish();
+        void frame();
+        void stream();
         void dftRunner();
-        void pretreatment();
+        void analyze(const int row, sample_t* re, sample_t* im, double* amp, double* mag, double* phase, double* power,
+                     int& index, double& value);
+        double refinePeak(const sample_t* re, const sample_t* im, const double* mag, const int index, double& amp) const;
+        double estimatePeak(const sample_t* window, const sample_t* re, const sample_t* im, const double* mag,
+                            const int index, double& amp);
+        ProtocolTask runTreatment(const int id, std::function<void(bool)> done);
 
         explicit Neureset();
         static Neureset* instance;
@@ -69,11 +178,37 @@ class Neureset {
         static Neureset* getInstance();
         ~Neureset();
 
-        void helmet(double* const* const* brain);
+        void helmet(Matrix<double>* brain);
+        void setSpectralEngine(SpectralEngine<sample_t>* engine);
+        bool addFilter(FilterStage<sample_t>* stage);
+        void clearFilters();
         void setSite(const int site);
 
         void generator();
+        void setStreaming(const bool streaming);
+        bool isStreaming() const;
+        void setRefreshPeriod(const int period);
+        int getRefreshPeriod() const;
+        bool setInputRate(const int rate);
+        void clearInput();
+        void push(const sample_t* samples, const int count);
+        bool isExternal() const;
+        void setNoise(const NoiseGenerator::Type type);
+        void seedNoise(const uint64_t seed);
+        void setWelch(const Window::Type type, const int segment, const int overlap, const int average);
+        void clearWelch();
+        void setMultitaper(const double nw, const int tapers);
+        void clearMultitaper();
+        void setZoom(const double low, const double high, const int points);
+        void clearZoom();
+        void setPeakMethod(const PeakRefiner::Method method);
+        PeakRefiner::Method getPeakMethod() const;
+        int openSession();
+        void closeSession(const int id);
+        ProtocolTask treatSite(const int id);
+        void beginTreatment(std::function<void(bool)> done);
         void treatment();
+        ProtocolScheduler& getScheduler();
 
         bool togglePause();
         void resetProgress();
@@ -85,16 +220,29 @@ class Neureset {
         // Spectrum analyzer
         const QVector<double>& getDomainDFT() const;
         const QVector<double>& getAmpDFT() const;
-
-        const double& getDomFreq() const;
-        const double& getPeakFreqAmp() const;
+        const QVector<double>& getMagDFT() const;
+        const QVector<double>& getPhaseDFT() const;
+        const QVector<double>& getPowerDFT() const;
+        const QVector<double>& getPSD() const;
+        const double& getPSDPeakFreq() const;
+        const QVector<double>& getMultitaperDFT() const;
+        QVector<BandStats> getBandPowers(const int site) const;
+        const QVector<double>& getZoomDomain() const;
+        const QVector<double>& getZoomDFT() const;
+        SpectrogramView getSpectrogram(const int site) const;
+        void clearSpectrogram();
+
+        double getDomFreq() const;
+        double getPeakFreqAmp() const;
         const int& getProgress() const;
 
         std::mutex& getMutex();
+        const BrainSnapshot& getSnapshot();
 
         const double& getTreatAmp() const;
 
         double getOverallBaseline();
+        QVector<SitePeak> getSiteBaselines();
         int getSite() const;
 };
 #endif
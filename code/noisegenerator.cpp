@@ -0,0 +1,180 @@
+#include "noisegenerator.h"
+
+
+NoiseGenerator::NoiseGenerator(const int channels, const uint64_t seed) :
+        channels(channels), state(new uint64_t[channels * NOISE_LANES * 4]),
+        pinkState(new double[channels * 3]()), cursor(new int[channels]()), spare(new double[channels]()),
+        pending(new bool[channels]()), scratch(channels) {
+    this->seed(seed);
+}
+
+NoiseGenerator::~NoiseGenerator() {
+    delete[] state;
+    delete[] pinkState;
+    delete[] cursor;
+    delete[] spare;
+    delete[] pending;
+}
+
+
+/*
+    Expands seed through splitmix64 into the first generator, every other lane and channel
+    is the previous one jumped ahead. Same seed, same streams.
+*/
+void NoiseGenerator::seed(const uint64_t seed) {
+    uint64_t x = seed;
+
+    for (int w = 0; w < 4; ++w) {
+        uint64_t z = (x += 0x9e3779b97f4a7c15ULL);
+        z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+        z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+        state[w] = z ^ (z >> 31);
+    }
+
+    for (int g = 1; g < channels * NOISE_LANES; ++g) {
+        for (int w = 0; w < 4; ++w)
+            state[g * 4 + w] = state[(g - 1) * 4 + w];
+        jump(state + g * 4);
+    }
+
+    for (int i = 0; i < channels * 3; ++i)
+        pinkState[i] = 0.;
+
+    for (int c = 0; c < channels; ++c) {
+        cursor[c] = 0;
+        pending[c] = false;
+    }
+}
+
+
+/*
+    Advances a generator by 2^128 draws, reference polynomial.
+*/
+void NoiseGenerator::jump(uint64_t* s) {
+    static const uint64_t polynomial[4] = {0x180ec6d33cfd0abaULL, 0xd5a61266f0c9392cULL,
+                                           0xa9582618e03fc9aaULL, 0x39abdc4529b1661cULL};
+    uint64_t jumped[4] = {0, 0, 0, 0};
+
+    for (int i = 0; i < 4; ++i)
+        for (int b = 0; b < 64; ++b) {
+            if (polynomial[i] & (1ULL << b))
+                for (int w = 0; w < 4; ++w)
+                    jumped[w] ^= s[w];
+            next(s);
+        }
+
+    for (int w = 0; w < 4; ++w)
+        s[w] = jumped[w];
+}
+
+
+/*
+    count uniforms in [0, 1), 53 bit, lanes round robin from the channel's cursor.
+*/
+void NoiseGenerator::uniformBlock(const int channel, double* out, const int count) {
+    uint64_t* const lanes = state + channel * NOISE_LANES * 4;
+    int l = cursor[channel];
+    int i = 0;
+
+    // up to the next round
+    for (; l != 0 && i < count; ++i, l = (l + 1) % NOISE_LANES)
+        out[i] = static_cast<double>(next(lanes + l * 4) >> 11) * 0x1.0p-53;
+
+    for (; i + NOISE_LANES <= count; i += NOISE_LANES)
+        for (int k = 0; k < NOISE_LANES; ++k)
+            out[i + k] = static_cast<double>(next(lanes + k * 4) >> 11) * 0x1.0p-53;
+
+    for (; i < count; ++i, l = (l + 1) % NOISE_LANES)
+        out[i] = static_cast<double>(next(lanes + l * 4) >> 11) * 0x1.0p-53;
+
+    cursor[channel] = l;
+}
+
+
+/*
+    count unit variance gaussians, Box-Muller pairs in place over the uniforms.
+
+    A pair split by the end of the block keeps its second half for the next block, out holds
+    count + 1 values.
+*/
+void NoiseGenerator::gaussianBlock(const int channel, double* out, const int count) {
+    int i = 0;
+    if (pending[channel] && count > 0) {
+        out[i++] = spare[channel];
+        pending[channel] = false;
+    }
+
+    const int pairs = (count - i + 1) / 2;
+    uniformBlock(channel, out + i, 2 * pairs);
+
+    for (int end = i + 2 * pairs; i < end; i += 2) {
+        const double radius = std::sqrt(-2. * std::log(1. - out[i]));
+        const double angle = 2. * PI * out[i + 1];
+        out[i] = radius * std::cos(angle);
+        out[i + 1] = radius * std::sin(angle);
+    }
+
+    if (i > count) {
+        spare[channel] = out[count];
+        pending[channel] = true;
+    }
+}
+
+
+/*
+    Fills count samples of the channel's stream, overwriting out.
+*/
+template <typename T>
+void NoiseGenerator::fill(const Type type, const int channel, T* out, const int count, const double amplitude) {
+    std::vector<double>& white = scratch[channel];
+    if (static_cast<int>(white.size()) < count + 1)
+        white.resize(count + 1);
+
+    if (type == UNIFORM) {
+        uniformBlock(channel, white.data(), count);
+        for (int i = 0; i < count; ++i)
+            out[i] = static_cast<T>((2. * white[i] - 1.) * amplitude);
+        return;
+    }
+
+    // unit variance, scaled to the power of the uniform
+    const double sigma = amplitude / std::sqrt(3.);
+    gaussianBlock(channel, white.data(), count);
+    const double* const gaussians = white.data();
+
+    if (type == GAUSSIAN) {
+        for (int i = 0; i < count; ++i)
+            out[i] = static_cast<T>(gaussians[i] * sigma);
+        return;
+    }
+
+    // kellet economy pink filter, state carries across blocks, rms 2.979 for unit white input
+    double* const poles = pinkState + channel * 3;
+    const double gain = sigma / 2.979;
+
+    for (int i = 0; i < count; ++i) {
+        const double x = gaussians[i];
+        poles[0] = 0.99765 * poles[0] + x * 0.0990460;
+        poles[1] = 0.96300 * poles[1] + x * 0.2965164;
+        poles[2] = 0.57000 * poles[2] + x * 1.0526913;
+        out[i] = static_cast<T>((poles[0] + poles[1] + poles[2] + x * 0.1848) * gain);
+    }
+}
+
+template void NoiseGenerator::fill<float>(const Type type, const int channel, float* out, const int count,
+                                          const double amplitude);
+template void NoiseGenerator::fill<double>(const Type type, const int channel, double* out, const int count,
+                                           const double amplitude);
+
+
+int NoiseGenerator::getChannels() const {
+    return channels;
+}
+
+const char* NoiseGenerator::getName(const Type type) {
+    switch (type) {
+        case GAUSSIAN: return "gaussian";
+        case PINK: return "pink";
+        default: return "uniform";
+    }
+}
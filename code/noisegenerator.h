@@ -0,0 +1,85 @@
+#ifndef NOISEGENERATOR_H
+#define NOISEGENERATOR_H
+
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+#include "defs.h"
+
+// interleaved generators per channel, independent dependency chains in a block fill
+#define NOISE_LANES 4
+
+
+/*
+    Block noise source, one independent stream per channel.
+
+    xoshiro256** (Blackman, Vigna). Every channel owns NOISE_LANES generators, each 2^128 draws
+    apart via jump(), so streams never overlap and a block is filled round robin across lanes
+    without the serial dependency of a single state. Seeding is explicit and reproducible.
+
+    The lane cursor, the unused half of a Box-Muller pair and the pink poles carry across blocks,
+    so a stream is the same however the caller splits it into blocks.
+
+        UNIFORM     [-amplitude, amplitude]
+        GAUSSIAN    zero mean, same power as UNIFORM (sigma = amplitude / sqrt 3), Box-Muller
+        PINK        1 / f, gaussian through Kellet's three pole filter, same power
+
+    A channel must be filled from one thread at a time, different channels may run in parallel.
+*/
+class NoiseGenerator {
+    public:
+        enum Type { UNIFORM, GAUSSIAN, PINK };
+
+    private:
+        const int channels;
+        uint64_t* const state;  // channels x lanes x 4 words
+        double* const pinkState; // channels x 3 poles
+        int* const cursor;       // channels, lane of the next draw
+        double* const spare;     // channels, second gaussian of the last pair
+        bool* const pending;     // channels, spare not yet used
+
+        std::vector<std::vector<double>> scratch; // per channel, grown to the largest block
+
+        static uint64_t rotl(const uint64_t x, const int k);
+        static uint64_t next(uint64_t* s);
+        static void jump(uint64_t* s);
+
+        void uniformBlock(const int channel, double* out, const int count);
+        void gaussianBlock(const int channel, double* out, const int count);
+
+    public:
+        NoiseGenerator(const int channels, const uint64_t seed);
+        ~NoiseGenerator();
+
+        void seed(const uint64_t seed);
+
+        template <typename T>
+        void fill(const Type type, const int channel, T* out, const int count, const double amplitude);
+
+        int getChannels() const;
+        static const char* getName(const Type type);
+};
+
+
+inline uint64_t NoiseGenerator::rotl(const uint64_t x, const int k) {
+    return (x << k) | (x >> (64 - k));
+}
+
+/*
+    One xoshiro256** step.
+*/
+inline uint64_t NoiseGenerator::next(uint64_t* s) {
+    const uint64_t result = rotl(s[1] * 5, 7) * 9;
+    const uint64_t t = s[1] << 17;
+
+    s[2] ^= s[0];
+    s[3] ^= s[1];
+    s[1] ^= s[2];
+    s[0] ^= s[3];
+    s[2] ^= t;
+    s[3] = rotl(s[3], 45);
+
+    return result;
+}
+#endif
@@ -0,0 +1,103 @@
+#include "oscillator.h"
+
+
+Oscillator::Oscillator(const double freq, const double rate, const double phase) :
+        phasor(std::polar(1., phase)), step(std::polar(1., static_cast<double>(2. * PI * freq / rate))),
+        freq(freq), rate(rate), phase(phase), sinceRenorm(0) {
+    stride = std::polar(1., static_cast<double>(2. * PI * freq * OSCILLATOR_LANES / rate));
+}
+
+
+/*
+    Phasor at absolute sample n. The angle is reduced by whole periods first, which keeps
+    it exact for large n.
+*/
+void Oscillator::seek(const long long n) {
+    const double cycles = freq * static_cast<double>(n) / rate;
+    const double angle = static_cast<double>(2. * PI * (cycles - std::floor(cycles))) + phase;
+
+    phasor = std::polar(1., angle);
+    sinceRenorm = 0;
+}
+
+
+/*
+    count samples written (add = false) or added (add = true) onto out.
+
+    Whole groups of lanes first, the phasor is then rebuilt from the first lane and the tail
+    finishes one sample at a time.
+*/
+template <typename T, bool add>
+void Oscillator::run(T* out, const int count, const double amplitude) {
+    // split real / imaginary so the lane loops map onto vector registers
+    double re[OSCILLATOR_LANES];
+    double im[OSCILLATOR_LANES];
+    std::complex<double> lane = phasor;
+    for (int k = 0; k < OSCILLATOR_LANES; ++k) {
+        re[k] = lane.real();
+        im[k] = lane.imag();
+        lane = mul(lane, step);
+    }
+
+    const double sr = stride.real();
+    const double si = stride.imag();
+
+    int i = 0;
+    for (; i + OSCILLATOR_LANES <= count; i += OSCILLATOR_LANES) {
+        for (int k = 0; k < OSCILLATOR_LANES; ++k) {
+            const T value = static_cast<T>(amplitude * re[k]);
+            out[i + k] = add ? out[i + k] + value : value;
+        }
+
+        for (int k = 0; k < OSCILLATOR_LANES; ++k) {
+            const double r = re[k] * sr - im[k] * si;
+            im[k] = re[k] * si + im[k] * sr;
+            re[k] = r;
+        }
+
+        sinceRenorm += OSCILLATOR_LANES;
+        if (sinceRenorm >= OSCILLATOR_RENORM) {
+            for (int k = 0; k < OSCILLATOR_LANES; ++k) {
+                const double scale = (3. - re[k] * re[k] - im[k] * im[k]) / 2.;
+                re[k] *= scale;
+                im[k] *= scale;
+            }
+            sinceRenorm = 0;
+        }
+    }
+
+    phasor = std::complex<double>(re[0], im[0]);
+
+    for (; i < count; ++i) {
+        const T value = static_cast<T>(amplitude * phasor.real());
+        out[i] = add ? out[i] + value : value;
+        advance();
+    }
+}
+
+
+/*
+    count samples, overwriting out.
+*/
+template <typename T>
+void Oscillator::fill(T* out, const int count, const double amplitude) {
+    run<T, false>(out, count, amplitude);
+}
+
+/*
+    count samples added onto out - mixing tones, or subtracting with a negative amplitude.
+*/
+template <typename T>
+void Oscillator::accumulate(T* out, const int count, const double amplitude) {
+    run<T, true>(out, count, amplitude);
+}
+
+template void Oscillator::fill<float>(float* out, const int count, const double amplitude);
+template void Oscillator::fill<double>(double* out, const int count, const double amplitude);
+template void Oscillator::accumulate<float>(float* out, const int count, const double amplitude);
+template void Oscillator::accumulate<double>(double* out, const int count, const double amplitude);
+
+
+double Oscillator::getFrequency() const {
+    return freq;
+}
@@ -0,0 +1,75 @@
+#ifndef OSCILLATOR_H
+#define OSCILLATOR_H
+
+#include <cmath>
+#include <complex>
+
+#include "defs.h"
+
+// samples between magnitude corrections of the phasor
+#define OSCILLATOR_RENORM 128
+// phasors stepped in parallel, n + k for k < lanes, each moving by step^lanes
+#define OSCILLATOR_LANES 8
+
+
+/*
+    Sine source by a rotating phasor, no transcendental call per sample.
+
+        z[n + 1] = z[n] e^(i 2 pi freq / rate),  out = amplitude Re(z) = amplitude cos(2 pi freq n / rate + phase)
+
+    Rounding lets |z| wander, it is pulled back to 1 every OSCILLATOR_RENORM samples with
+    z *= (3 - |z|^2) / 2, which keeps amplitude error near machine precision over any length.
+
+    Blocks run OSCILLATOR_LANES phasors a sample apart, each rotated by step^lanes, so the
+    multiplies form independent chains instead of one serial recurrence.
+
+    seek places the phasor at an absolute sample index with one sincos, so block-wise synthesis
+    matches cos(2 pi freq n / rate) exactly at every block start.
+*/
+class Oscillator {
+    private:
+        std::complex<double> phasor;
+        std::complex<double> step;
+        std::complex<double> stride;     // step^lanes
+        double freq;
+        double rate;
+        double phase;
+        int sinceRenorm;
+
+        void advance();
+        static std::complex<double> mul(const std::complex<double>& a, const std::complex<double>& b);
+
+        template <typename T, bool add>
+        void run(T* out, const int count, const double amplitude);
+
+    public:
+        Oscillator(const double freq, const double rate, const double phase = 0.);
+
+        void seek(const long long n);
+
+        template <typename T>
+        void fill(T* out, const int count, const double amplitude);
+        template <typename T>
+        void accumulate(T* out, const int count, const double amplitude);
+
+        double getFrequency() const;
+};
+
+
+// spelled out, std::complex operator* goes through __muldc3
+inline std::complex<double> Oscillator::mul(const std::complex<double>& a, const std::complex<double>& b) {
+    return std::complex<double>(a.real() * b.real() - a.imag() * b.imag(), a.real() * b.imag() + a.imag() * b.real());
+}
+
+/*
+    One sample forward, renormalizing when due.
+*/
+inline void Oscillator::advance() {
+    phasor = mul(phasor, step);
+
+    if (++sinceRenorm >= OSCILLATOR_RENORM) {
+        phasor *= (3. - std::norm(phasor)) / 2.;
+        sinceRenorm = 0;
+    }
+}
+#endif
@@ -0,0 +1,158 @@
+#ifndef PARALLEL_H
+#define PARALLEL_H
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+
+/*
+    Persistent workers behind parallelFor, one per core besides the caller, started on first use
+    and joined at exit. A call costs a queue push and a wake, not a thread.
+
+    A job is a number of chunks claimed in order by whoever gets to them first. The caller claims
+    chunks too and only waits for the ones already running, so a parallelFor inside a chunk, or
+    several at once, never waits on a busy pool.
+*/
+class WorkerPool {
+    private:
+        struct Job {
+            std::function<void(int)> chunk;
+            int chunks;
+            std::atomic<int> next;      // first unclaimed chunk
+            std::atomic<int> remaining; // chunks not finished
+
+            std::mutex lock;
+            std::condition_variable finished;
+        };
+
+        std::mutex lock;
+        std::condition_variable changed;
+        std::deque<std::shared_ptr<Job>> queue; // one entry per helper wanted
+        bool running;
+        std::vector<std::thread> threads;
+
+        WorkerPool() : running(true) {
+            const int cores = std::max(1, static_cast<int>(std::thread::hardware_concurrency()));
+
+            for (int i = 1; i < cores; ++i)
+                threads.emplace_back(&WorkerPool::work, this);
+        }
+
+        // claims and runs chunks until none are left
+        static void help(Job& job) {
+            for (int c = job.next++; c < job.chunks; c = job.next++) {
+                job.chunk(c);
+
+                if (--job.remaining == 0) {
+                    std::lock_guard<std::mutex> guard(job.lock);
+                    job.finished.notify_all();
+                }
+            }
+        }
+
+        void work() {
+            std::unique_lock<std::mutex> guard(lock);
+
+            while (true) {
+                changed.wait(guard, [this]() { return !running || !queue.empty(); });
+                if (!running)
+                    return;
+
+                const std::shared_ptr<Job> job = std::move(queue.front());
+                queue.pop_front();
+
+                guard.unlock();
+                help(*job);
+                guard.lock();
+            }
+        }
+
+    public:
+        WorkerPool(const WorkerPool&) = delete;
+        WorkerPool& operator=(const WorkerPool&) = delete;
+
+        ~WorkerPool() {
+            {
+                std::lock_guard<std::mutex> guard(lock);
+                running = false;
+            }
+            changed.notify_all();
+
+            for (std::thread& thread : threads)
+                thread.join();
+        }
+
+        static WorkerPool& getInstance() {
+            static WorkerPool pool;
+            return pool;
+        }
+
+        // threads besides the caller
+        int getWorkers() const {
+            return static_cast<int>(threads.size());
+        }
+
+        /*
+            chunk(c) for c in [0, chunks), returns once all have run.
+        */
+        void run(const int chunks, std::function<void(int)> chunk) {
+            const std::shared_ptr<Job> job = std::make_shared<Job>();
+            job->chunk = std::move(chunk);
+            job->chunks = chunks;
+            job->next = 0;
+            job->remaining = chunks;
+
+            const int helpers = std::min(chunks - 1, getWorkers());
+            if (helpers > 0) {
+                {
+                    std::lock_guard<std::mutex> guard(lock);
+                    for (int i = 0; i < helpers; ++i)
+                        queue.push_back(job);
+                }
+                changed.notify_all();
+            }
+
+            help(*job);
+
+            std::unique_lock<std::mutex> guard(job->lock);
+            job->finished.wait(guard, [&job]() { return job->remaining == 0; });
+        }
+};
+
+
+/*
+    Splits [begin, end) into contiguous chunks, one per core, none smaller than grain.
+
+    fn(first, last) runs on the calling thread and the WorkerPool,
+    a single chunk runs inline without touching the pool.
+*/
+template <typename Function>
+void parallelFor(const int begin, const int end, const int grain, Function fn) {
+    const int count = end - begin;
+    if (count <= 0)
+        return;
+
+    const int cores = std::max(1, static_cast<int>(std::thread::hardware_concurrency()));
+    const int workers = std::min(cores, (count + grain - 1) / std::max(1, grain));
+
+    if (workers <= 1) {
+        fn(begin, end);
+        return;
+    }
+
+    const int chunk = (count + workers - 1) / workers;
+    const int chunks = (count + chunk - 1) / chunk;
+
+    WorkerPool::getInstance().run(chunks, [begin, end, chunk, &fn](const int c) {
+        const int first = begin + c * chunk;
+        fn(first, std::min(first + chunk, end));
+    });
+}
+#endif
@@ -0,0 +1,69 @@
+#include "peakrefiner.h"
+
+
+template <typename T>
+double PeakRefiner::refine(const Method method, const T* re, const T* im, const double* mag, const int bins,
+                           const int index, const int pad, double& amp) {
+    amp = mag[index];
+
+    // needs a neighbour on both sides
+    if (method == NONE || index <= 0 || index >= bins - 1)
+        return 0.;
+
+    const double left = mag[index - 1];
+    const double centre = mag[index];
+    const double right = mag[index + 1];
+    double offset = 0.;
+
+    const int step = std::max(1, pad);
+
+    if (method == JACOBSEN && re && im && index >= step && index < bins - step) {
+        const double lr = re[index - step], li = im[index - step];
+        const double cr = re[index], ci = im[index];
+        const double rr = re[index + step], ri = im[index + step];
+
+        const double nr = rr - lr, ni = ri - li;                   // X+ - X-
+        const double dr = 2. * cr - lr - rr, di = 2. * ci - li - ri; // 2 X0 - X- - X+
+        const double norm = dr * dr + di * di;
+
+        if (norm > 0.)
+            offset = -step * (nr * dr + ni * di) / norm;
+    } else if (method == GAUSSIAN && left > 0. && centre > 0. && right > 0.) {
+        const double a = std::log(left), b = std::log(centre), c = std::log(right);
+        const double denominator = a - 2. * b + c;
+
+        if (denominator < 0.) {
+            offset = std::max(-0.5, std::min(0.5, 0.5 * (a - c) / denominator));
+            amp = std::exp(b - 0.25 * (a - c) * offset);
+            return offset;
+        }
+    } else {
+        const double denominator = left - 2. * centre + right;
+
+        if (denominator < 0.)
+            offset = 0.5 * (left - right) / denominator;
+    }
+
+    offset = std::max(-0.5, std::min(0.5, offset));
+
+    // parabolic vertex height
+    amp = centre - 0.25 * (left - right) * offset;
+
+    return offset;
+}
+
+template double PeakRefiner::refine<float>(const Method method, const float* re, const float* im, const double* mag,
+                                           const int bins, const int index, const int pad, double& amp);
+template double PeakRefiner::refine<double>(const Method method, const double* re, const double* im, const double* mag,
+                                            const int bins, const int index, const int pad, double& amp);
+
+
+const char* PeakRefiner::getName(const Method method) {
+    switch (method) {
+        case PARABOLIC: return "parabolic";
+        case GAUSSIAN: return "gaussian";
+        case JACOBSEN: return "jacobsen";
+        case ZOOM: return "zoom";
+        default: return "none";
+    }
+}
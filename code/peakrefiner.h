@@ -0,0 +1,34 @@
+#ifndef PEAKREFINER_H
+#define PEAKREFINER_H
+
+#include <algorithm>
+#include <cmath>
+
+#include "defs.h"
+
+
+/*
+    Sub-bin peak location from the argmax bin and its two neighbours.
+
+    Returns the fractional bin offset in [-0.5, 0.5] and the interpolated amplitude, so the peak
+    is read to a fraction of the bin spacing without a longer window. O(1) per spectrum.
+
+        PARABOLIC   vertex of a parabola through the three magnitudes
+        GAUSSIAN    same through log magnitudes, exact for gaussian shaped peaks
+        JACOBSEN    complex bins, -Re[(X+ - X-) / (2 X0 - X- - X+)], falls back to parabolic
+                    without re / im. Derived for unpadded bins: with pad times zero padding
+                    the neighbours pad bins away are used.
+        ZOOM        argmax of a chirp-z zoom spectrum (Neureset::setZoom), parabolic between
+                    zoom bins. Parabolic here, the zoom itself lives in Neureset.
+*/
+class PeakRefiner {
+    public:
+        enum Method { NONE, PARABOLIC, GAUSSIAN, JACOBSEN, ZOOM };
+
+        template <typename T>
+        static double refine(const Method method, const T* re, const T* im, const double* mag, const int bins,
+                             const int index, const int pad, double& amp);
+
+        static const char* getName(const Method method);
+};
+#endif
@@ -0,0 +1,254 @@
+#include "protocolscheduler.h"
+
+#include <iterator>
+
+
+ProtocolScheduler::ProtocolScheduler(Clock& clock) : clock(clock), busy(false), nextSession(0), nextOrder(0),
+                                                     running(true), thread(&ProtocolScheduler::run, this) {}
+
+/*
+    Joins after the task in progress, then runs the cancel tasks of everything still pending
+    on this thread. Schedule calls from them are refused.
+*/
+ProtocolScheduler::~ProtocolScheduler() {
+    std::vector<Task> cancels;
+    {
+        std::lock_guard<std::mutex> guard(lock);
+        running = false;
+
+        for (Event& event : queue) {
+            if (event.session == NO_SESSION)
+                cancels.push_back(std::move(event.task)); // already a cancel, from close
+            else if (event.cancel)
+                cancels.push_back(std::move(event.cancel));
+        }
+        for (auto& session : sessions)
+            for (auto& held : session.second.held)
+                if (held.second.cancel)
+                    cancels.push_back(std::move(held.second.cancel));
+
+        queue.clear();
+        sessions.clear();
+    }
+    changed.notify_all();
+    thread.join();
+
+    for (Task& cancel : cancels)
+        cancel();
+}
+
+
+// heap order, std heaps keep the largest on top
+bool ProtocolScheduler::later(const Event& a, const Event& b) {
+    return a.due > b.due || (a.due == b.due && a.order > b.order);
+}
+
+
+/*
+    Sleeps until the earliest deadline or a change, runs what is due.
+*/
+void ProtocolScheduler::run() {
+    std::unique_lock<std::mutex> guard(lock);
+
+    while (running) {
+        if (queue.empty()) {
+            idle.notify_all();
+            changed.wait(guard);
+            continue;
+        }
+
+        const Clock::time_point due = queue.front().due; // a copy, the heap can move while waiting
+        if (clock.now() < due) {
+            idle.notify_all();
+            clock.waitUntil(guard, changed, due);
+            continue;
+        }
+
+        std::pop_heap(queue.begin(), queue.end(), later);
+        Task task = std::move(queue.back().task);
+        queue.pop_back();
+
+        busy = true;
+        guard.unlock();
+        task();
+        task = nullptr; // captures go before the lock is retaken
+        guard.lock();
+        busy = false;
+    }
+
+    idle.notify_all();
+}
+
+
+/*
+    Into the queue, lock held.
+*/
+void ProtocolScheduler::post(Event&& event) {
+    queue.push_back(std::move(event));
+    std::push_heap(queue.begin(), queue.end(), later);
+}
+
+
+/*
+    New session, returns its id.
+*/
+int ProtocolScheduler::open() {
+    std::lock_guard<std::mutex> guard(lock);
+
+    const int id = nextSession++;
+    sessions[id] = Session{false, {}};
+    return id;
+}
+
+/*
+    task runs delay ms from now (from resume, for the time left, if the session is paused).
+    cancel, if given, runs instead should the session close first.
+
+    returns:
+        false if the session is closed, neither runs
+*/
+bool ProtocolScheduler::schedule(const int session, const int delay, Task task, Task cancel) {
+    {
+        std::lock_guard<std::mutex> guard(lock);
+
+        auto found = sessions.find(session);
+        if (found == sessions.end())
+            return false;
+
+        const Clock::duration wait = std::chrono::milliseconds(std::max(0, delay));
+        Event event{clock.now() + wait, nextOrder++, session, std::move(task), std::move(cancel)};
+
+        if (found->second.paused) {
+            found->second.held.emplace_back(wait, std::move(event));
+            return true;
+        }
+
+        post(std::move(event));
+    }
+
+    changed.notify_one();
+    return true;
+}
+
+
+/*
+    Freezes the session, its clock stops with it.
+*/
+void ProtocolScheduler::pause(const int session) {
+    std::lock_guard<std::mutex> guard(lock);
+
+    auto found = sessions.find(session);
+    if (found == sessions.end() || found->second.paused)
+        return;
+
+    Session& state = found->second;
+    state.paused = true;
+
+    const Clock::time_point now = clock.now();
+    auto moved = std::partition(queue.begin(), queue.end(), [session](const Event& event) {
+        return event.session != session;
+    });
+
+    for (auto it = moved; it != queue.end(); ++it)
+        state.held.emplace_back(std::max(Clock::duration::zero(), it->due - now), std::move(*it));
+
+    queue.erase(moved, queue.end());
+    std::make_heap(queue.begin(), queue.end(), later);
+    // the earliest deadline can only have moved later, the thread wakes and finds nothing due
+}
+
+void ProtocolScheduler::resume(const int session) {
+    {
+        std::lock_guard<std::mutex> guard(lock);
+
+        auto found = sessions.find(session);
+        if (found == sessions.end() || !found->second.paused)
+            return;
+
+        Session& state = found->second;
+        state.paused = false;
+
+        const Clock::time_point now = clock.now();
+        for (auto& held : state.held) {
+            held.second.due = now + held.first;
+            post(std::move(held.second));
+        }
+        state.held.clear();
+    }
+
+    changed.notify_one();
+}
+
+/*
+    Ends the session, nothing pending runs. Cancel tasks are queued to run now.
+*/
+void ProtocolScheduler::close(const int session) {
+    {
+        std::lock_guard<std::mutex> guard(lock);
+
+        auto found = sessions.find(session);
+        if (found == sessions.end())
+            return;
+
+        std::vector<Event> dropped;
+        for (auto& held : found->second.held)
+            dropped.push_back(std::move(held.second));
+        sessions.erase(found);
+
+        auto moved = std::partition(queue.begin(), queue.end(), [session](const Event& event) {
+            return event.session != session;
+        });
+        std::move(moved, queue.end(), std::back_inserter(dropped));
+        queue.erase(moved, queue.end());
+        std::make_heap(queue.begin(), queue.end(), later);
+
+        const Clock::time_point now = clock.now();
+        for (Event& event : dropped)
+            if (event.cancel)
+                post(Event{now, nextOrder++, NO_SESSION, std::move(event.cancel), nullptr});
+    }
+
+    changed.notify_one();
+}
+
+
+/*
+    Blocks until nothing is due and no task is running. Not from a task.
+*/
+void ProtocolScheduler::flush() {
+    std::unique_lock<std::mutex> guard(lock);
+
+    idle.wait(guard, [this]() {
+        return !running || (!busy && (queue.empty() || clock.now() < queue.front().due));
+    });
+}
+
+
+bool ProtocolScheduler::isOpen(const int session) const {
+    std::lock_guard<std::mutex> guard(lock);
+    return sessions.count(session) != 0;
+}
+
+bool ProtocolScheduler::isPaused(const int session) const {
+    std::lock_guard<std::mutex> guard(lock);
+
+    auto found = sessions.find(session);
+    return found != sessions.end() && found->second.paused;
+}
+
+// open sessions
+int ProtocolScheduler::getSessions() const {
+    std::lock_guard<std::mutex> guard(lock);
+    return static_cast<int>(sessions.size());
+}
+
+// queued and held events
+int ProtocolScheduler::getPending() const {
+    std::lock_guard<std::mutex> guard(lock);
+
+    std::size_t held = 0;
+    for (const auto& session : sessions)
+        held += session.second.held.size();
+
+    return static_cast<int>(queue.size() + held);
+}
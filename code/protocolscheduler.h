@@ -0,0 +1,97 @@
+#ifndef PROTOCOLSCHEDULER_H
+#define PROTOCOLSCHEDULER_H
+
+#include <algorithm>
+#include <condition_variable>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "clock.h"
+#include "defs.h"
+
+// session of internal events, never opened
+#define NO_SESSION -1
+
+
+/*
+    Timed protocol steps for any number of sessions on one thread.
+
+    A session is a group of pending events (a task due after a delay). Tasks run in deadline order
+    on the scheduler thread and schedule their own follow-ups, so a protocol is a chain of short
+    steps rather than a thread sleeping through it.
+
+    One min-heap of deadlines and a condition variable: the thread sleeps until the earliest
+    deadline or until the queue changes, so pause / resume / close take effect as soon as the
+    call returns, not at the next poll.
+
+        pause   pending events are lifted out with their remaining time, new ones are held too
+        resume  held events go back in, due after the time they had left
+        close   pending events are dropped, later schedule calls are refused
+
+    An event may carry a cancel task, run (on the scheduler thread, right away) instead of being
+    dropped when its session closes, or on the destroying thread when the scheduler goes first.
+    Coroutines (ProtocolTask) use it to unwind rather than stay suspended forever.
+
+    Tasks run without the scheduler lock held and may call back into it. A task already running
+    when its session is paused or closed finishes, anything it schedules is held or refused.
+    flush waits out what is due, e.g. the cancel tasks of a session just closed.
+
+    Deadlines are on the shared Clock, a simulated one runs the protocol faster than real time.
+*/
+class ProtocolScheduler {
+    public:
+        typedef std::function<void()> Task;
+
+    private:
+        struct Event {
+            Clock::time_point due;
+            long long order;        // ties run in scheduling order
+            int session;            // NO_SESSION for cancel tasks, immune to pause / close
+            Task task;
+            Task cancel;
+        };
+
+        struct Session {
+            bool paused;
+            std::vector<std::pair<Clock::duration, Event>> held; // remaining time, event
+        };
+
+        Clock& clock;
+
+        mutable std::mutex lock;
+        std::condition_variable changed;
+        std::condition_variable idle;   // nothing due and no task running
+        bool busy;
+
+        std::vector<Event> queue;       // heap, earliest on top
+        std::map<int, Session> sessions;
+
+        int nextSession;
+        long long nextOrder;
+        bool running;
+        std::thread thread;
+
+        static bool later(const Event& a, const Event& b);
+        void run();
+        void post(Event&& event);
+
+    public:
+        explicit ProtocolScheduler(Clock& clock = Clock::getInstance());
+        ~ProtocolScheduler();
+
+        int open();
+        bool schedule(const int session, const int delay, Task task, Task cancel = nullptr);
+        void pause(const int session);
+        void resume(const int session);
+        void close(const int session);
+        void flush();
+
+        bool isOpen(const int session) const;
+        bool isPaused(const int session) const;
+        int getSessions() const;
+        int getPending() const;
+};
+#endif
@@ -0,0 +1,150 @@
+#ifndef PROTOCOLTASK_H
+#define PROTOCOLTASK_H
+
+#include <coroutine>
+#include <exception>
+#include <utility>
+
+#include "protocolscheduler.h"
+
+
+/*
+    Coroutine for protocol code, run by ProtocolScheduler. C++20.
+
+    A suspended session costs its coroutine frame (locals and awaiters, a few hundred bytes),
+    not a thread.
+
+    Lazy: nothing runs until the task is awaited or started.
+        co_await child          runs child on this thread, continues here once it returns
+        task.start(s, session)  top level, first step on the scheduler thread, the frame frees
+                                itself when the body ends
+
+    Timers come from co_await ProtocolSleep, which follows the session's pause and close.
+*/
+class ProtocolTask {
+    public:
+        struct promise_type;
+        typedef std::coroutine_handle<promise_type> Handle;
+
+    private:
+        // hands control to the awaiting coroutine, or frees a started one
+        struct FinalAwaiter {
+            bool await_ready() const noexcept {
+                return false;
+            }
+
+            std::coroutine_handle<> await_suspend(Handle handle) noexcept {
+                promise_type& promise = handle.promise();
+                if (promise.continuation)
+                    return promise.continuation;
+
+                if (promise.detached)
+                    handle.destroy();
+                return std::noop_coroutine();
+            }
+
+            void await_resume() const noexcept {}
+        };
+
+        Handle handle;
+
+        explicit ProtocolTask(const Handle handle) : handle(handle) {}
+
+    public:
+        struct promise_type {
+            std::coroutine_handle<> continuation;
+            bool detached = false;
+
+            ProtocolTask get_return_object() {
+                return ProtocolTask(Handle::from_promise(*this));
+            }
+
+            std::suspend_always initial_suspend() noexcept {
+                return {};
+            }
+
+            FinalAwaiter final_suspend() noexcept {
+                return {};
+            }
+
+            void return_void() {}
+
+            void unhandled_exception() {
+                std::terminate();
+            }
+        };
+
+        ProtocolTask(ProtocolTask&& other) noexcept : handle(std::exchange(other.handle, nullptr)) {}
+        ProtocolTask(const ProtocolTask&) = delete;
+        ProtocolTask& operator=(const ProtocolTask&) = delete;
+
+        ~ProtocolTask() {
+            if (handle)
+                handle.destroy();
+        }
+
+        bool await_ready() const noexcept {
+            return !handle || handle.done();
+        }
+
+        std::coroutine_handle<> await_suspend(std::coroutine_handle<> parent) noexcept {
+            handle.promise().continuation = parent;
+            return handle;
+        }
+
+        void await_resume() const noexcept {}
+
+        /*
+            Detaches and runs from the scheduler thread. The first step is an event of session,
+            a closed session (now or before it runs) still starts it so the body can finish,
+            directly on this thread if the session is already gone.
+        */
+        void start(ProtocolScheduler& scheduler, const int session) {
+            const Handle started = std::exchange(handle, nullptr);
+            started.promise().detached = true;
+
+            const ProtocolScheduler::Task run = [started]() { started.resume(); };
+            if (!scheduler.schedule(session, 0, run, run))
+                started.resume();
+        }
+};
+
+
+/*
+    co_await ProtocolSleep(scheduler, session, ms)
+
+    Resumes on the scheduler thread after ms of unpaused session time, true. If the session
+    closes first it resumes at once with false, so the protocol can return.
+
+    ms 0 continues straight away, or once the session resumes if it is paused.
+*/
+class ProtocolSleep {
+    private:
+        ProtocolScheduler& scheduler;
+        const int session;
+        const int delay;
+        bool elapsed;
+
+    public:
+        ProtocolSleep(ProtocolScheduler& scheduler, const int session, const int delay) :
+                scheduler(scheduler), session(session), delay(delay), elapsed(false) {}
+
+        bool await_ready() const noexcept {
+            return false;
+        }
+
+        // once scheduled the coroutine may resume on the other thread, nothing here is touched after
+        bool await_suspend(const std::coroutine_handle<> handle) {
+            return scheduler.schedule(session, delay, [this, handle]() {
+                elapsed = true;
+                handle.resume();
+            }, [handle]() {
+                handle.resume();
+            });
+        }
+
+        bool await_resume() const noexcept {
+            return elapsed;
+        }
+};
+#endif
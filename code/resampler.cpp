@@ -0,0 +1,129 @@
+#include "resampler.h"
+
+#include <cassert>
+
+
+template <typename T>
+Resampler<T>::Resampler(const int inRate, const int outRate) :
+        inRate(inRate), outRate(outRate),
+        up(outRate / std::gcd(inRate, outRate)), down(inRate / std::gcd(inRate, outRate)),
+        taps(2 * RESAMPLER_ZEROS * std::max(1, (down + up - 1) / up)),
+        phases(static_cast<std::size_t>(up) * taps), extended(taps - 1, T(0)), time(0) {
+    assert(inRate > 0 && outRate > 0); // down == 0 never consumes input
+    design();
+    reset();
+}
+
+
+/*
+    Prototype h[j], j in [0, up * taps), blackman windowed sinc with unity dc gain per phase.
+
+    Phase p holds h[p + k up] times up, stored reversed so the dot product walks the input forward.
+*/
+template <typename T>
+void Resampler<T>::design() {
+    const int length = up * taps;
+    const double cutoff = RESAMPLER_ROLLOFF * 0.5 / std::max(up, down); // cycles per upsampled sample
+    const double centre = (length - 1) / 2.;
+
+    std::vector<double> window(length);
+    Window::fill(Window::BLACKMAN, window.data(), std::max(1, length - 1));
+    if (length > 1)
+        window[length - 1] = window[0];
+
+    std::vector<double> prototype(length);
+    double sum = 0.;
+
+    for (int j = 0; j < length; ++j) {
+        const double x = j - centre;
+        const double sinc = x == 0. ? 2. * cutoff : std::sin(2. * PI * cutoff * x) / (PI * x);
+        prototype[j] = sinc * window[j];
+        sum += prototype[j];
+    }
+
+    for (int p = 0; p < up; ++p)
+        for (int k = 0; k < taps; ++k)
+            phases[p * taps + (taps - 1 - k)] = static_cast<T>(prototype[p + k * up] * up / sum);
+}
+
+
+/*
+    count new inputs, oldest first. Writes up to getMaxOutput(count) outputs, returns how many.
+
+        output at upsampled time t: input n = t / L, phase t % L, t advances by M
+*/
+template <typename T>
+int Resampler<T>::process(const T* in, const int count, T* out) {
+    const int past = taps - 1;
+
+    extended.resize(static_cast<std::size_t>(past + count));
+    std::copy(in, in + count, extended.begin() + past);
+
+    const long long available = static_cast<long long>(past + count) * up;
+    int produced = 0;
+
+    for (; time < available; time += down) {
+        const int n = static_cast<int>(time / up);
+        const T* const coefficients = phases.data() + (time % up) * taps;
+        const T* const x = extended.data() + n - past;
+
+        T sum = 0;
+        for (int k = 0; k < taps; ++k)
+            sum += coefficients[k] * x[k];
+
+        out[produced++] = sum;
+    }
+
+    // keep the newest taps - 1 inputs, rebase time onto them
+    std::copy(extended.end() - past, extended.end(), extended.begin());
+    extended.resize(past);
+    time -= static_cast<long long>(count) * up;
+
+    return produced;
+}
+
+
+/*
+    Empty history, next output lines up with the next input.
+*/
+template <typename T>
+void Resampler<T>::reset() {
+    extended.assign(taps - 1, T(0));
+    time = static_cast<long long>(taps - 1) * up;
+}
+
+
+// outputs one process call can produce for count inputs
+template <typename T>
+int Resampler<T>::getMaxOutput(const int count) const {
+    return static_cast<int>((static_cast<long long>(count) * up + down - 1) / down) + 1;
+}
+
+template <typename T>
+int Resampler<T>::getInRate() const {
+    return inRate;
+}
+
+template <typename T>
+int Resampler<T>::getOutRate() const {
+    return outRate;
+}
+
+template <typename T>
+int Resampler<T>::getUp() const {
+    return up;
+}
+
+template <typename T>
+int Resampler<T>::getDown() const {
+    return down;
+}
+
+template <typename T>
+int Resampler<T>::getTaps() const {
+    return taps;
+}
+
+
+template class Resampler<float>;
+template class Resampler<double>;
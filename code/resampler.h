@@ -0,0 +1,59 @@
+#ifndef RESAMPLER_H
+#define RESAMPLER_H
+
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+#include <vector>
+
+#include "defs.h"
+#include "window.h"
+
+// sinc zero crossings kept each side of the resampling filter at the lower of the two rates
+#define RESAMPLER_ZEROS 8
+// passband edge as a fraction of the lower nyquist
+#define RESAMPLER_ROLLOFF 0.9
+
+
+/*
+    Rational polyphase resampler, inRate to outRate by L / M (reduced).
+
+    One windowed-sinc lowpass at L x inRate, cut below the lower nyquist, split into L phases of
+    taps coefficients. Each output picks its phase and runs one taps long dot product over the
+    input history, so only the kept samples are computed and the upsampled signal never exists.
+    Decimating 4 khz to 204 hz costs taps multiplies per output sample, none per dropped input.
+
+    Streaming: taps - 1 inputs of history and the output phase carry across blocks.
+    Latency is about taps / 2 input samples.
+
+    Instantiated for float and double.
+*/
+template <typename T>
+class Resampler {
+    private:
+        const int inRate;
+        const int outRate;
+        const int up;              // L
+        const int down;            // M
+        const int taps;            // per phase
+
+        std::vector<T> phases;     // up x taps, reversed, oldest input first
+        std::vector<T> extended;   // taps - 1 history then the block
+        long long time;            // next output at L x rate, relative to extended[0]
+
+        void design();
+
+    public:
+        Resampler(const int inRate, const int outRate);
+
+        int process(const T* in, const int count, T* out);
+        void reset();
+
+        int getMaxOutput(const int count) const;
+        int getInRate() const;
+        int getOutRate() const;
+        int getUp() const;
+        int getDown() const;
+        int getTaps() const;
+};
+#endif
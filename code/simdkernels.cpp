@@ -0,0 +1,539 @@
+#include "simdkernels.h"
+
+#if SIMD_X86
+#include <immintrin.h>
+#endif
+
+template <typename T>
+static void dftScalar(const T* in, const int size,
+                      const T* cosRows, const T* sinRows, const int stride,
+                      T* re, T* im, const int bins) {
+    for (int k = 0; k < bins; ++k) {
+        re[k] = 0;
+        im[k] = 0;
+    }
+
+    for (int n = 0; n < size; ++n) {
+        const T x = in[n];
+        const T* const cosRow = cosRows + n * stride;
+        const T* const sinRow = sinRows + n * stride;
+
+        for (int k = 0; k < bins; ++k) {
+            re[k] += x * cosRow[k];
+            im[k] += x * sinRow[k];
+        }
+    }
+}
+
+template <typename T>
+static void axpyScalar(const T a, const T* x, T* y, const int count) {
+    for (int i = 0; i < count; ++i)
+        y[i] += a * x[i];
+}
+
+/*
+    Channel at a time, state in registers over all frames. count channels, frames stride apart.
+*/
+template <typename T>
+static void biquadChannels(T* data, const int frames, const int stride, const int count, const T* coefficients,
+                           T* z1, T* z2) {
+    const T b0 = coefficients[0], b1 = coefficients[1], b2 = coefficients[2];
+    const T a1 = coefficients[3], a2 = coefficients[4];
+
+    for (int c = 0; c < count; ++c) {
+        T s1 = z1[c];
+        T s2 = z2[c];
+
+        for (int n = 0; n < frames; ++n) {
+            T* const sample = data + n * stride + c;
+            const T x = *sample;
+            const T y = b0 * x + s1;
+            s1 = b1 * x - a1 * y + s2;
+            s2 = b2 * x - a2 * y;
+            *sample = y;
+        }
+
+        z1[c] = s1;
+        z2[c] = s2;
+    }
+}
+
+template <typename T>
+static void biquadScalar(T* data, const int frames, const int channels, const T* coefficients, T* z1, T* z2) {
+    biquadChannels(data, frames, channels, channels, coefficients, z1, z2);
+}
+
+#if SIMD_X86
+
+/*
+    Two blocks of 4 bins kept in registers over all samples.
+
+    Rows are padded to stride (one cache line multiple) with zeros, so reads past bins are safe,
+    only the stores are clipped.
+*/
+__attribute__((target("avx2,fma")))
+static void dftAvx2(const double* in, const int size,
+                    const double* cosRows, const double* sinRows, const int stride,
+                    double* re, double* im, const int bins) {
+    alignas(32) double tail[16];
+
+    for (int k = 0; k < bins; k += 8) {
+        __m256d re0 = _mm256_setzero_pd();
+        __m256d re1 = _mm256_setzero_pd();
+        __m256d im0 = _mm256_setzero_pd();
+        __m256d im1 = _mm256_setzero_pd();
+
+        for (int n = 0; n < size; ++n) {
+            const __m256d x = _mm256_broadcast_sd(in + n);
+            const double* const cosRow = cosRows + n * stride + k;
+            const double* const sinRow = sinRows + n * stride + k;
+
+            re0 = _mm256_fmadd_pd(x, _mm256_load_pd(cosRow), re0);
+            re1 = _mm256_fmadd_pd(x, _mm256_load_pd(cosRow + 4), re1);
+            im0 = _mm256_fmadd_pd(x, _mm256_load_pd(sinRow), im0);
+            im1 = _mm256_fmadd_pd(x, _mm256_load_pd(sinRow + 4), im1);
+        }
+
+        if (k + 8 <= bins) {
+            _mm256_storeu_pd(re + k, re0);
+            _mm256_storeu_pd(re + k + 4, re1);
+            _mm256_storeu_pd(im + k, im0);
+            _mm256_storeu_pd(im + k + 4, im1);
+        } else {
+            _mm256_store_pd(tail, re0);
+            _mm256_store_pd(tail + 4, re1);
+            _mm256_store_pd(tail + 8, im0);
+            _mm256_store_pd(tail + 12, im1);
+
+            for (int j = 0; k + j < bins; ++j) {
+                re[k + j] = tail[j];
+                im[k + j] = tail[8 + j];
+            }
+        }
+    }
+}
+
+
+/*
+    Same blocking as avx2, 8 bins per register.
+*/
+__attribute__((target("avx512f")))
+static void dftAvx512(const double* in, const int size,
+                      const double* cosRows, const double* sinRows, const int stride,
+                      double* re, double* im, const int bins) {
+    for (int k = 0; k < bins; k += 16) {
+        __m512d re0 = _mm512_setzero_pd();
+        __m512d re1 = _mm512_setzero_pd();
+        __m512d im0 = _mm512_setzero_pd();
+        __m512d im1 = _mm512_setzero_pd();
+
+        // second block may fall past the padded stride
+        const bool second = k + 8 < bins;
+
+        for (int n = 0; n < size; ++n) {
+            const __m512d x = _mm512_set1_pd(in[n]);
+            const double* const cosRow = cosRows + n * stride + k;
+            const double* const sinRow = sinRows + n * stride + k;
+
+            re0 = _mm512_fmadd_pd(x, _mm512_load_pd(cosRow), re0);
+            im0 = _mm512_fmadd_pd(x, _mm512_load_pd(sinRow), im0);
+
+            if (second) {
+                re1 = _mm512_fmadd_pd(x, _mm512_load_pd(cosRow + 8), re1);
+                im1 = _mm512_fmadd_pd(x, _mm512_load_pd(sinRow + 8), im1);
+            }
+        }
+
+        const int first = bins - k < 8 ? bins - k : 8;
+        const __mmask8 mask0 = static_cast<__mmask8>((1u << first) - 1);
+        _mm512_mask_storeu_pd(re + k, mask0, re0);
+        _mm512_mask_storeu_pd(im + k, mask0, im0);
+
+        if (second) {
+            const int rest = bins - k - 8 < 8 ? bins - k - 8 : 8;
+            const __mmask8 mask1 = static_cast<__mmask8>((1u << rest) - 1);
+            _mm512_mask_storeu_pd(re + k + 8, mask1, re1);
+            _mm512_mask_storeu_pd(im + k + 8, mask1, im1);
+        }
+    }
+}
+
+/*
+    Two blocks of 8 float bins.
+*/
+__attribute__((target("avx2,fma")))
+static void dftAvx2(const float* in, const int size,
+                    const float* cosRows, const float* sinRows, const int stride,
+                    float* re, float* im, const int bins) {
+    alignas(32) float tail[32];
+
+    for (int k = 0; k < bins; k += 16) {
+        __m256 re0 = _mm256_setzero_ps();
+        __m256 re1 = _mm256_setzero_ps();
+        __m256 im0 = _mm256_setzero_ps();
+        __m256 im1 = _mm256_setzero_ps();
+
+        for (int n = 0; n < size; ++n) {
+            const __m256 x = _mm256_broadcast_ss(in + n);
+            const float* const cosRow = cosRows + n * stride + k;
+            const float* const sinRow = sinRows + n * stride + k;
+
+            re0 = _mm256_fmadd_ps(x, _mm256_load_ps(cosRow), re0);
+            re1 = _mm256_fmadd_ps(x, _mm256_load_ps(cosRow + 8), re1);
+            im0 = _mm256_fmadd_ps(x, _mm256_load_ps(sinRow), im0);
+            im1 = _mm256_fmadd_ps(x, _mm256_load_ps(sinRow + 8), im1);
+        }
+
+        if (k + 16 <= bins) {
+            _mm256_storeu_ps(re + k, re0);
+            _mm256_storeu_ps(re + k + 8, re1);
+            _mm256_storeu_ps(im + k, im0);
+            _mm256_storeu_ps(im + k + 8, im1);
+        } else {
+            _mm256_store_ps(tail, re0);
+            _mm256_store_ps(tail + 8, re1);
+            _mm256_store_ps(tail + 16, im0);
+            _mm256_store_ps(tail + 24, im1);
+
+            for (int j = 0; k + j < bins; ++j) {
+                re[k + j] = tail[j];
+                im[k + j] = tail[16 + j];
+            }
+        }
+    }
+}
+
+
+/*
+    Two blocks of 16 float bins.
+*/
+__attribute__((target("avx512f")))
+static void dftAvx512(const float* in, const int size,
+                      const float* cosRows, const float* sinRows, const int stride,
+                      float* re, float* im, const int bins) {
+    for (int k = 0; k < bins; k += 32) {
+        __m512 re0 = _mm512_setzero_ps();
+        __m512 re1 = _mm512_setzero_ps();
+        __m512 im0 = _mm512_setzero_ps();
+        __m512 im1 = _mm512_setzero_ps();
+
+        // second block may fall past the padded stride
+        const bool second = k + 16 < bins;
+
+        for (int n = 0; n < size; ++n) {
+            const __m512 x = _mm512_set1_ps(in[n]);
+            const float* const cosRow = cosRows + n * stride + k;
+            const float* const sinRow = sinRows + n * stride + k;
+
+            re0 = _mm512_fmadd_ps(x, _mm512_load_ps(cosRow), re0);
+            im0 = _mm512_fmadd_ps(x, _mm512_load_ps(sinRow), im0);
+
+            if (second) {
+                re1 = _mm512_fmadd_ps(x, _mm512_load_ps(cosRow + 16), re1);
+                im1 = _mm512_fmadd_ps(x, _mm512_load_ps(sinRow + 16), im1);
+            }
+        }
+
+        const int first = bins - k < 16 ? bins - k : 16;
+        const __mmask16 mask0 = static_cast<__mmask16>((1u << first) - 1);
+        _mm512_mask_storeu_ps(re + k, mask0, re0);
+        _mm512_mask_storeu_ps(im + k, mask0, im0);
+
+        if (second) {
+            const int rest = bins - k - 16 < 16 ? bins - k - 16 : 16;
+            const __mmask16 mask1 = static_cast<__mmask16>((1u << rest) - 1);
+            _mm512_mask_storeu_ps(re + k + 16, mask1, re1);
+            _mm512_mask_storeu_ps(im + k + 16, mask1, im1);
+        }
+    }
+}
+
+
+/*
+    Filter kernels. axpy runs 4 / 8 lanes with a scalar tail, biquad keeps one register of
+    channels (state included) over all frames, remaining channels go scalar.
+*/
+__attribute__((target("avx2,fma")))
+static void axpyAvx2(const double a, const double* x, double* y, const int count) {
+    const __m256d va = _mm256_set1_pd(a);
+    int i = 0;
+
+    for (; i + 4 <= count; i += 4)
+        _mm256_storeu_pd(y + i, _mm256_fmadd_pd(va, _mm256_loadu_pd(x + i), _mm256_loadu_pd(y + i)));
+    for (; i < count; ++i)
+        y[i] += a * x[i];
+}
+
+__attribute__((target("avx2,fma")))
+static void axpyAvx2(const float a, const float* x, float* y, const int count) {
+    const __m256 va = _mm256_set1_ps(a);
+    int i = 0;
+
+    for (; i + 8 <= count; i += 8)
+        _mm256_storeu_ps(y + i, _mm256_fmadd_ps(va, _mm256_loadu_ps(x + i), _mm256_loadu_ps(y + i)));
+    for (; i < count; ++i)
+        y[i] += a * x[i];
+}
+
+__attribute__((target("avx512f")))
+static void axpyAvx512(const double a, const double* x, double* y, const int count) {
+    const __m512d va = _mm512_set1_pd(a);
+
+    for (int i = 0; i < count; i += 8) {
+        const int lanes = count - i < 8 ? count - i : 8;
+        const __mmask8 mask = static_cast<__mmask8>((1u << lanes) - 1);
+        const __m512d vy = _mm512_maskz_loadu_pd(mask, y + i);
+        _mm512_mask_storeu_pd(y + i, mask, _mm512_fmadd_pd(va, _mm512_maskz_loadu_pd(mask, x + i), vy));
+    }
+}
+
+__attribute__((target("avx512f")))
+static void axpyAvx512(const float a, const float* x, float* y, const int count) {
+    const __m512 va = _mm512_set1_ps(a);
+
+    for (int i = 0; i < count; i += 16) {
+        const int lanes = count - i < 16 ? count - i : 16;
+        const __mmask16 mask = static_cast<__mmask16>((1u << lanes) - 1);
+        const __m512 vy = _mm512_maskz_loadu_ps(mask, y + i);
+        _mm512_mask_storeu_ps(y + i, mask, _mm512_fmadd_ps(va, _mm512_maskz_loadu_ps(mask, x + i), vy));
+    }
+}
+
+
+__attribute__((target("avx2,fma")))
+static void biquadAvx2(double* data, const int frames, const int channels, const double* coefficients,
+                       double* z1, double* z2) {
+    const __m256d b0 = _mm256_set1_pd(coefficients[0]), b1 = _mm256_set1_pd(coefficients[1]);
+    const __m256d b2 = _mm256_set1_pd(coefficients[2]);
+    const __m256d a1 = _mm256_set1_pd(coefficients[3]), a2 = _mm256_set1_pd(coefficients[4]);
+    int c = 0;
+
+    for (; c + 4 <= channels; c += 4) {
+        __m256d s1 = _mm256_loadu_pd(z1 + c);
+        __m256d s2 = _mm256_loadu_pd(z2 + c);
+
+        for (int n = 0; n < frames; ++n) {
+            double* const frame = data + n * channels + c;
+            const __m256d x = _mm256_loadu_pd(frame);
+            const __m256d y = _mm256_fmadd_pd(b0, x, s1);
+            s1 = _mm256_fmadd_pd(b1, x, _mm256_fnmadd_pd(a1, y, s2));
+            s2 = _mm256_fnmadd_pd(a2, y, _mm256_mul_pd(b2, x));
+            _mm256_storeu_pd(frame, y);
+        }
+
+        _mm256_storeu_pd(z1 + c, s1);
+        _mm256_storeu_pd(z2 + c, s2);
+    }
+
+    if (c < channels)
+        biquadChannels(data + c, frames, channels, channels - c, coefficients, z1 + c, z2 + c);
+}
+
+__attribute__((target("avx2,fma")))
+static void biquadAvx2(float* data, const int frames, const int channels, const float* coefficients,
+                       float* z1, float* z2) {
+    const __m256 b0 = _mm256_set1_ps(coefficients[0]), b1 = _mm256_set1_ps(coefficients[1]);
+    const __m256 b2 = _mm256_set1_ps(coefficients[2]);
+    const __m256 a1 = _mm256_set1_ps(coefficients[3]), a2 = _mm256_set1_ps(coefficients[4]);
+    int c = 0;
+
+    for (; c + 8 <= channels; c += 8) {
+        __m256 s1 = _mm256_loadu_ps(z1 + c);
+        __m256 s2 = _mm256_loadu_ps(z2 + c);
+
+        for (int n = 0; n < frames; ++n) {
+            float* const frame = data + n * channels + c;
+            const __m256 x = _mm256_loadu_ps(frame);
+            const __m256 y = _mm256_fmadd_ps(b0, x, s1);
+            s1 = _mm256_fmadd_ps(b1, x, _mm256_fnmadd_ps(a1, y, s2));
+            s2 = _mm256_fnmadd_ps(a2, y, _mm256_mul_ps(b2, x));
+            _mm256_storeu_ps(frame, y);
+        }
+
+        _mm256_storeu_ps(z1 + c, s1);
+        _mm256_storeu_ps(z2 + c, s2);
+    }
+
+    if (c < channels)
+        biquadChannels(data + c, frames, channels, channels - c, coefficients, z1 + c, z2 + c);
+}
+
+/*
+    Masked, the last register of channels is partial instead of scalar.
+*/
+__attribute__((target("avx512f")))
+static void biquadAvx512(double* data, const int frames, const int channels, const double* coefficients,
+                         double* z1, double* z2) {
+    const __m512d b0 = _mm512_set1_pd(coefficients[0]), b1 = _mm512_set1_pd(coefficients[1]);
+    const __m512d b2 = _mm512_set1_pd(coefficients[2]);
+    const __m512d a1 = _mm512_set1_pd(coefficients[3]), a2 = _mm512_set1_pd(coefficients[4]);
+
+    for (int c = 0; c < channels; c += 8) {
+        const int lanes = channels - c < 8 ? channels - c : 8;
+        const __mmask8 mask = static_cast<__mmask8>((1u << lanes) - 1);
+        __m512d s1 = _mm512_maskz_loadu_pd(mask, z1 + c);
+        __m512d s2 = _mm512_maskz_loadu_pd(mask, z2 + c);
+
+        for (int n = 0; n < frames; ++n) {
+            double* const frame = data + n * channels + c;
+            const __m512d x = _mm512_maskz_loadu_pd(mask, frame);
+            const __m512d y = _mm512_fmadd_pd(b0, x, s1);
+            s1 = _mm512_fmadd_pd(b1, x, _mm512_fnmadd_pd(a1, y, s2));
+            s2 = _mm512_fnmadd_pd(a2, y, _mm512_mul_pd(b2, x));
+            _mm512_mask_storeu_pd(frame, mask, y);
+        }
+
+        _mm512_mask_storeu_pd(z1 + c, mask, s1);
+        _mm512_mask_storeu_pd(z2 + c, mask, s2);
+    }
+}
+
+__attribute__((target("avx512f")))
+static void biquadAvx512(float* data, const int frames, const int channels, const float* coefficients,
+                         float* z1, float* z2) {
+    const __m512 b0 = _mm512_set1_ps(coefficients[0]), b1 = _mm512_set1_ps(coefficients[1]);
+    const __m512 b2 = _mm512_set1_ps(coefficients[2]);
+    const __m512 a1 = _mm512_set1_ps(coefficients[3]), a2 = _mm512_set1_ps(coefficients[4]);
+
+    for (int c = 0; c < channels; c += 16) {
+        const int lanes = channels - c < 16 ? channels - c : 16;
+        const __mmask16 mask = static_cast<__mmask16>((1u << lanes) - 1);
+        __m512 s1 = _mm512_maskz_loadu_ps(mask, z1 + c);
+        __m512 s2 = _mm512_maskz_loadu_ps(mask, z2 + c);
+
+        for (int n = 0; n < frames; ++n) {
+            float* const frame = data + n * channels + c;
+            const __m512 x = _mm512_maskz_loadu_ps(mask, frame);
+            const __m512 y = _mm512_fmadd_ps(b0, x, s1);
+            s1 = _mm512_fmadd_ps(b1, x, _mm512_fnmadd_ps(a1, y, s2));
+            s2 = _mm512_fnmadd_ps(a2, y, _mm512_mul_ps(b2, x));
+            _mm512_mask_storeu_ps(frame, mask, y);
+        }
+
+        _mm512_mask_storeu_ps(z1 + c, mask, s1);
+        _mm512_mask_storeu_ps(z2 + c, mask, s2);
+    }
+}
+
+#endif
+
+const SimdKernels::Level SimdKernels::level = SimdKernels::detect();
+const SimdKernels::DftKernel<double> SimdKernels::kernelDouble = SimdKernels::getKernel<double>(SimdKernels::level);
+const SimdKernels::DftKernel<float> SimdKernels::kernelFloat = SimdKernels::getKernel<float>(SimdKernels::level);
+const SimdKernels::AxpyKernel<double> SimdKernels::axpyDouble = SimdKernels::getAxpyKernel<double>(SimdKernels::level);
+const SimdKernels::AxpyKernel<float> SimdKernels::axpyFloat = SimdKernels::getAxpyKernel<float>(SimdKernels::level);
+const SimdKernels::BiquadKernel<double> SimdKernels::biquadDouble =
+        SimdKernels::getBiquadKernel<double>(SimdKernels::level);
+const SimdKernels::BiquadKernel<float> SimdKernels::biquadFloat =
+        SimdKernels::getBiquadKernel<float>(SimdKernels::level);
+
+
+/*
+    CPUID query, once at static initialization.
+*/
+SimdKernels::Level SimdKernels::detect() {
+#if SIMD_X86
+    __builtin_cpu_init();
+
+    if (__builtin_cpu_supports("avx512f"))
+        return AVX512;
+    if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma"))
+        return AVX2;
+#endif
+    return SCALAR;
+}
+
+
+/*
+    Kernel for a level, falls back to scalar when not compiled in.
+
+    Exposed so the vector paths can be checked against scalar.
+*/
+template <typename T>
+SimdKernels::DftKernel<T> SimdKernels::getKernel(const Level level) {
+    switch (level) {
+#if SIMD_X86
+        case AVX512: return dftAvx512;
+        case AVX2: return dftAvx2;
+#endif
+        default: return dftScalar<T>;
+    }
+}
+
+template SimdKernels::DftKernel<float> SimdKernels::getKernel<float>(const Level level);
+template SimdKernels::DftKernel<double> SimdKernels::getKernel<double>(const Level level);
+
+
+template <typename T>
+SimdKernels::AxpyKernel<T> SimdKernels::getAxpyKernel(const Level level) {
+    switch (level) {
+#if SIMD_X86
+        case AVX512: return axpyAvx512;
+        case AVX2: return axpyAvx2;
+#endif
+        default: return axpyScalar<T>;
+    }
+}
+
+template SimdKernels::AxpyKernel<float> SimdKernels::getAxpyKernel<float>(const Level level);
+template SimdKernels::AxpyKernel<double> SimdKernels::getAxpyKernel<double>(const Level level);
+
+
+template <typename T>
+SimdKernels::BiquadKernel<T> SimdKernels::getBiquadKernel(const Level level) {
+    switch (level) {
+#if SIMD_X86
+        case AVX512: return biquadAvx512;
+        case AVX2: return biquadAvx2;
+#endif
+        default: return biquadScalar<T>;
+    }
+}
+
+template SimdKernels::BiquadKernel<float> SimdKernels::getBiquadKernel<float>(const Level level);
+template SimdKernels::BiquadKernel<double> SimdKernels::getBiquadKernel<double>(const Level level);
+
+
+void SimdKernels::dft(const double* in, const int size,
+                      const double* cosRows, const double* sinRows, const int stride,
+                      double* re, double* im, const int bins) {
+    kernelDouble(in, size, cosRows, sinRows, stride, re, im, bins);
+}
+
+void SimdKernels::dft(const float* in, const int size,
+                      const float* cosRows, const float* sinRows, const int stride,
+                      float* re, float* im, const int bins) {
+    kernelFloat(in, size, cosRows, sinRows, stride, re, im, bins);
+}
+
+
+void SimdKernels::axpy(const double a, const double* x, double* y, const int count) {
+    axpyDouble(a, x, y, count);
+}
+
+void SimdKernels::axpy(const float a, const float* x, float* y, const int count) {
+    axpyFloat(a, x, y, count);
+}
+
+void SimdKernels::biquad(double* data, const int frames, const int channels, const double* coefficients,
+                         double* z1, double* z2) {
+    biquadDouble(data, frames, channels, coefficients, z1, z2);
+}
+
+void SimdKernels::biquad(float* data, const int frames, const int channels, const float* coefficients,
+                         float* z1, float* z2) {
+    biquadFloat(data, frames, channels, coefficients, z1, z2);
+}
+
+
+SimdKernels::Level SimdKernels::getLevel() {
+    return level;
+}
+
+const char* SimdKernels::getName(const Level level) {
+    switch (level) {
+        case AVX512: return "avx512";
+        case AVX2: return "avx2";
+        default: return "scalar";
+    }
+}
@@ -0,0 +1,76 @@
+#ifndef SIMDKERNELS_H
+#define SIMDKERNELS_H
+
+#include "defs.h"
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define SIMD_X86 1
+#else
+#define SIMD_X86 0
+#endif
+
+
+/*
+    Vectorized partial DFT kernels, selected once at startup from CPUID.
+
+    Coefficient rows are cos / -sin per input sample, rows stride elements apart (see TwiddleTable):
+        re[k] = sum in[n] cosRows[n * stride + k]
+        im[k] = sum in[n] sinRows[n * stride + k]
+
+    avx512 handles 8 double / 16 float bins per instruction, avx2 4 / 8,
+    scalar is the fallback and the reference.
+
+    Filter kernels for FilterChain, vectorized across elements / channels the same way:
+        axpy    y[i] += a x[i]
+        biquad  transposed direct form II over frames x channels interleaved samples,
+                coefficients {b0, b1, b2, a1, a2}, one z1 / z2 per channel
+*/
+class SimdKernels {
+    public:
+        enum Level { SCALAR, AVX2, AVX512 };
+
+        template <typename T>
+        using DftKernel = void (*)(const T* in, const int size,
+                                   const T* cosRows, const T* sinRows, const int stride,
+                                   T* re, T* im, const int bins);
+        template <typename T>
+        using AxpyKernel = void (*)(const T a, const T* x, T* y, const int count);
+        template <typename T>
+        using BiquadKernel = void (*)(T* data, const int frames, const int channels, const T* coefficients,
+                                      T* z1, T* z2);
+
+        static void dft(const double* in, const int size,
+                        const double* cosRows, const double* sinRows, const int stride,
+                        double* re, double* im, const int bins);
+        static void dft(const float* in, const int size,
+                        const float* cosRows, const float* sinRows, const int stride,
+                        float* re, float* im, const int bins);
+
+        static void axpy(const double a, const double* x, double* y, const int count);
+        static void axpy(const float a, const float* x, float* y, const int count);
+        static void biquad(double* data, const int frames, const int channels, const double* coefficients,
+                           double* z1, double* z2);
+        static void biquad(float* data, const int frames, const int channels, const float* coefficients,
+                           float* z1, float* z2);
+
+        template <typename T>
+        static DftKernel<T> getKernel(const Level level);
+        template <typename T>
+        static AxpyKernel<T> getAxpyKernel(const Level level);
+        template <typename T>
+        static BiquadKernel<T> getBiquadKernel(const Level level);
+        static Level getLevel();
+        static const char* getName(const Level level);
+
+    private:
+        static Level detect();
+
+        static const Level level;
+        static const DftKernel<double> kernelDouble;
+        static const DftKernel<float> kernelFloat;
+        static const AxpyKernel<double> axpyDouble;
+        static const AxpyKernel<float> axpyFloat;
+        static const BiquadKernel<double> biquadDouble;
+        static const BiquadKernel<float> biquadFloat;
+};
+#endif
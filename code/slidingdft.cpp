@@ -0,0 +1,111 @@
+#include "slidingdft.h"
+
+
+template <typename T>
+SlidingDFT<T>::SlidingDFT(const int size, const int length, const int bins) :
+        size(size), length(length), bins(bins),
+        engine(SpectralEngine<T>::create(size, length, bins)),
+        ring(new T[size]()), window(new T[size]()),
+        head(0), pushed(0),
+        rotate(bins), enter(bins),
+        real(new T[bins]()), imag(new T[bins]()) {
+
+    for (int k = 0; k < bins; ++k) {
+        rotate[k] = std::complex<T>(DspTables::phasor(length, k));
+        enter[k] = std::complex<T>(std::conj(DspTables::phasor(length, static_cast<long long>(k) * (size - 1))));
+    }
+}
+
+template <typename T>
+SlidingDFT<T>::~SlidingDFT() {
+    delete engine;
+    delete[] ring;
+    delete[] window;
+    delete[] real;
+    delete[] imag;
+}
+
+
+/*
+    Replace the whole window, exact transform.
+*/
+template <typename T>
+void SlidingDFT<T>::reset(const T* samples) {
+    for (int n = 0; n < size; ++n)
+        ring[n] = samples[n];
+    head = 0;
+
+    resync();
+}
+
+
+template <typename T>
+void SlidingDFT<T>::resync() {
+    engine->transform(getWindow(), real, imag);
+    pushed = 0;
+}
+
+
+/*
+    Slide by one sample.
+*/
+template <typename T>
+void SlidingDFT<T>::push(const T sample) {
+    const T oldest = ring[head];
+    ring[head] = sample;
+    head = (head + 1) % size;
+
+    if (++pushed >= size) {
+        resync();
+        return;
+    }
+
+    for (int k = 0; k < bins; ++k) {
+        const T re = real[k] - oldest;
+        const T im = imag[k];
+
+        real[k] = rotate[k].real() * re - rotate[k].imag() * im + sample * enter[k].real();
+        imag[k] = rotate[k].real() * im + rotate[k].imag() * re + sample * enter[k].imag();
+    }
+}
+
+
+/*
+    Slide by a block, oldest first.
+
+    A block of a window or more is a reset.
+*/
+template <typename T>
+void SlidingDFT<T>::push(const T* samples, const int count) {
+    if (count >= size) {
+        reset(samples + count - size);
+        return;
+    }
+
+    for (int i = 0; i < count; ++i)
+        push(samples[i]);
+}
+
+
+template <typename T>
+const T* SlidingDFT<T>::getReal() const {
+    return real;
+}
+
+template <typename T>
+const T* SlidingDFT<T>::getImag() const {
+    return imag;
+}
+
+// current window, oldest first
+template <typename T>
+const T* SlidingDFT<T>::getWindow() {
+    for (int n = 0; n < size; ++n)
+        window[n] = ring[(head + n) % size];
+
+    return window;
+}
+
+
+template class SlidingDFT<float>;
+template class SlidingDFT<double>;
@@ -0,0 +1,53 @@
+#ifndef SLIDINGDFT_H
+#define SLIDINGDFT_H
+
+#include <complex>
+#include <vector>
+
+#include "defs.h"
+#include "spectralengine.h"
+
+
+/*
+    Streaming spectrum over the last size samples, same bins as SpectralEngine.
+
+    Each pushed sample updates every bin with one complex recurrence, O(bins):
+        X <- e^(i w) (X - oldest) + newest e^(-i w (size - 1))
+
+    The window is recomputed exactly once every size samples to stop rounding drift,
+    which keeps the amortized cost O(bins) per sample.
+*/
+template <typename T>
+class SlidingDFT {
+    private:
+        const int size;
+        const int length;
+        const int bins;
+
+        SpectralEngine<T>* const engine; // exact resync
+        T* const ring;                // last size samples, head is the oldest
+        T* const window;              // ring unrolled, oldest first
+        int head;
+        int pushed;                   // since last resync
+
+        std::vector<std::complex<T>> rotate; // e^(i w)
+        std::vector<std::complex<T>> enter;  // e^(-i w (size - 1))
+
+        T* const real;
+        T* const imag;
+
+        void resync();
+
+    public:
+        SlidingDFT(const int size, const int length, const int bins);
+        ~SlidingDFT();
+
+        void reset(const T* samples); // size samples, oldest first
+        void push(const T sample);
+        void push(const T* samples, const int count);
+
+        const T* getReal() const;
+        const T* getImag() const;
+        const T* getWindow();
+};
+#endif
@@ -0,0 +1,103 @@
+#ifndef SPECTRALENGINE_H
+#define SPECTRALENGINE_H
+
+#include <cmath>
+#include <complex>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "defs.h"
+#include "fft.h"
+#include "parallel.h"
+#include "simdkernels.h"
+#include "twiddletable.h"
+
+// largest size * bins handled by the vectorized direct DFT before switching to FFT
+#define DIRECT_DFT_LIMIT (1 << 16)
+// fewest rows per worker in batched transforms
+#define BATCH_GRAIN 4
+
+
+/*
+    Pluggable time to frequency transform used by Neureset.
+
+    size real samples are zero padded to length, the first bins are returned:
+        X[k] = sum x[n] e^(-2 pi i k n / length), k in [0, bins)
+
+    Unscaled. Engines keep their own work buffers, one engine per thread.
+
+    Batches take rows x size samples (row stride apart) and fill rows x bins (rows outStride apart),
+    row by row, rows spread across the WorkerPool. Strides let Matrix rows with aligned padding go in and out directly.
+
+    Instantiated for float and double samples.
+*/
+template <typename T>
+class SpectralEngine {
+    protected:
+        const int size;
+        const int length;
+        const int bins;
+
+    public:
+        SpectralEngine(const int size, const int length, const int bins);
+        virtual ~SpectralEngine();
+
+        virtual void transform(const T* in, T* re, T* im) = 0;
+        virtual void transformBatch(const T* in, const int rows, const int stride, T* re, T* im, const int outStride);
+
+        static SpectralEngine<T>* create(const int size, const int length, const int bins);
+
+        int getSize() const;
+        int getLength() const;
+        int getBins() const;
+};
+
+
+/*
+    Reference engine, partial DFT matrix. O(size * bins).
+
+    Pure multiply-accumulate over the shared twiddle table.
+*/
+template <typename T>
+class DirectDFT : public SpectralEngine<T> {
+    private:
+        const std::shared_ptr<const TwiddleTable<T>> table;
+
+    public:
+        DirectDFT(const int size, const int length, const int bins);
+
+        void transform(const T* in, T* re, T* im) override;
+        void transformBatch(const T* in, const int rows, const int stride, T* re, T* im, const int outStride) override;
+};
+
+
+/*
+    Mixed-radix FFT engine. O(length * sum(factors)).
+
+    Even lengths pack the real input into a half length complex FFT.
+*/
+template <typename T>
+class FFTEngine : public SpectralEngine<T> {
+    private:
+        const bool packed;
+        ComplexFFT<T> fft;
+
+        std::vector<std::complex<T>> input;
+        std::vector<std::complex<T>> output;
+        std::vector<std::complex<T>> unpack; // e^(-2 pi i k / length), split of packed halves
+
+        std::mutex spareMtx;
+        std::vector<FFTEngine<T>*> spare;    // work buffers of batch workers, kept between batches
+
+        FFTEngine<T>* acquire();
+        void release(FFTEngine<T>* local);
+
+    public:
+        FFTEngine(const int size, const int length, const int bins);
+        ~FFTEngine() override;
+
+        void transform(const T* in, T* re, T* im) override;
+        void transformBatch(const T* in, const int rows, const int stride, T* re, T* im, const int outStride) override;
+};
+#endif
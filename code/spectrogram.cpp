@@ -0,0 +1,74 @@
+#include "spectrogram.h"
+
+
+Spectrogram::Spectrogram(const int sites, const int depth, const int bins) :
+        sites(sites), depth(depth), bins(bins),
+        buffer(new double[static_cast<long long>(sites) * depth * bins]()),
+        heads(new int[sites]()), totals(new long long[sites]()) {}
+
+Spectrogram::~Spectrogram() {
+    delete[] buffer;
+    delete[] heads;
+    delete[] totals;
+}
+
+
+/*
+    Newest frame for a site, overwrites the oldest once full.
+*/
+void Spectrogram::push(const int site, const double* spectrum) {
+    if (site < 0 || site >= sites)
+        return;
+
+    double* const row = buffer + (static_cast<long long>(site) * depth + heads[site]) * bins;
+    for (int k = 0; k < bins; ++k)
+        row[k] = spectrum[k];
+
+    heads[site] = (heads[site] + 1) % depth;
+    ++totals[site];
+}
+
+
+void Spectrogram::clear(const int site) {
+    if (site < 0 || site >= sites)
+        return;
+
+    heads[site] = 0;
+    totals[site] = 0;
+}
+
+void Spectrogram::clear() {
+    for (int i = 0; i < sites; ++i)
+        clear(i);
+}
+
+
+/*
+    Zero copy view of a site's ring, oldest frame first.
+*/
+SpectrogramView Spectrogram::view(const int site) const {
+    SpectrogramView view = {nullptr, bins, depth, 0, 0, 0};
+    if (site < 0 || site >= sites)
+        return view;
+
+    view.data = buffer + static_cast<long long>(site) * depth * bins;
+    view.bins = bins;
+    view.depth = depth;
+    view.rows = totals[site] < depth ? static_cast<int>(totals[site]) : depth;
+    view.head = view.rows < depth ? 0 : heads[site];
+    view.total = totals[site];
+    return view;
+}
+
+
+int Spectrogram::getSites() const {
+    return sites;
+}
+
+int Spectrogram::getDepth() const {
+    return depth;
+}
+
+int Spectrogram::getBins() const {
+    return bins;
+}
@@ -0,0 +1,57 @@
+#ifndef SPECTROGRAM_H
+#define SPECTROGRAM_H
+
+#include "defs.h"
+
+
+/*
+    Read only window into one site's history, no copy.
+
+    Row 0 is the oldest frame, row(rows - 1) the newest. Valid until the next push,
+    read under the owner's lock.
+*/
+struct SpectrogramView {
+    const double* data;     // depth x bins ring
+    int bins;
+    int depth;
+    int rows;               // frames held, <= depth
+    int head;               // ring index of the oldest frame
+    long long total;        // frames pushed since clear
+
+    const double* row(const int i) const {
+        return data + ((head + i) % depth) * bins;
+    }
+};
+
+
+/*
+    Short time spectra of every site, the last depth frames each.
+
+    One preallocated sites x depth x bins block, pushing a frame copies bins values
+    into the ring and never allocates.
+*/
+class Spectrogram {
+    private:
+        const int sites;
+        const int depth;
+        const int bins;
+
+        double* const buffer;
+        int* const heads;       // next write per site
+        long long* const totals;
+
+    public:
+        Spectrogram(const int sites, const int depth, const int bins);
+        ~Spectrogram();
+
+        void push(const int site, const double* spectrum);
+        void clear(const int site);
+        void clear();
+
+        SpectrogramView view(const int site) const;
+
+        int getSites() const;
+        int getDepth() const;
+        int getBins() const;
+};
+#endif
@@ -0,0 +1,20 @@
+# Standalone checks, no Qt needed:
+#   qmake tests.pro && make check
+TEMPLATE = app
+TARGET = tst_simdkernels
+
+CONFIG += console c++20 testcase
+CONFIG -= app_bundle qt
+
+INCLUDEPATH += ..
+
+SOURCES += \
+    tst_simdkernels.cpp \
+    ../simdkernels.cpp \
+    ../twiddletable.cpp
+
+HEADERS += \
+    ../defs.h \
+    ../dsptables.h \
+    ../simdkernels.h \
+    ../twiddletable.h
@@ -0,0 +1,182 @@
+#include <cmath>
+#include <cstdio>
+#include <memory>
+#include <random>
+#include <vector>
+
+#include "simdkernels.h"
+#include "twiddletable.h"
+
+#define CHECK_SAMPLES 204 // one second, as Neureset samples
+
+
+/*
+    Checks every SIMD level the CPU runs against the scalar kernels.
+
+    Shapes cover whole vector blocks and partial tails (bins, counts, channels not a multiple of the
+    lane width). Results must agree within a tolerance relative to the magnitude of the inputs:
+        double  1e-12
+        float   1e-5
+    FMA and summation order differ between levels, so exact equality is not expected.
+
+    Exit code is the number of failed checks.
+*/
+
+static int failures = 0;
+
+template <typename T>
+static T tolerance();
+
+template <>
+double tolerance<double>() {
+    return 1e-12;
+}
+
+template <>
+float tolerance<float>() {
+    return 1e-5f;
+}
+
+template <typename T>
+static const char* typeName() {
+    return sizeof(T) == sizeof(double) ? "double" : "float";
+}
+
+// worst |a - b| over count values, against scale
+template <typename T>
+static void compare(const char* what, const SimdKernels::Level level, const int shape, const T* a, const T* b,
+                    const int count, const T scale) {
+    double worst = 0.;
+    for (int i = 0; i < count; ++i)
+        worst = std::fmax(worst, std::fabs(static_cast<double>(a[i]) - static_cast<double>(b[i])));
+
+    const double limit = tolerance<T>() * scale;
+    if (worst > limit) {
+        ++failures;
+        std::printf("FAIL %-6s %-6s %-6s shape %4d  error %.3g > %.3g\n", what, typeName<T>(),
+                    SimdKernels::getName(level), shape, worst, limit);
+    }
+}
+
+
+template <typename T>
+static void checkDft(const SimdKernels::Level level, std::mt19937& random) {
+    const SimdKernels::DftKernel<T> reference = SimdKernels::getKernel<T>(SimdKernels::SCALAR);
+    const SimdKernels::DftKernel<T> kernel = SimdKernels::getKernel<T>(level);
+    std::uniform_real_distribution<double> uniform(-50., 50.);
+
+    // 16 / 32 / 64 whole blocks for every lane width, the rest end in a partial block
+    for (const int bins : {1, 3, 7, 8, 13, 16, 17, 31, 32, 64, 103, 205}) {
+        const int size = CHECK_SAMPLES;
+        const std::shared_ptr<const TwiddleTable<T>> table = TwiddleTable<T>::get(size, 2 * size, bins);
+
+        std::vector<T> in(size);
+        T scale = 0;
+        for (T& x : in) {
+            x = static_cast<T>(uniform(random));
+            scale += std::fabs(x);
+        }
+
+        // one spare value past bins, kernels must not write it
+        std::vector<T> re(bins + 1, T(7)), im(bins + 1, T(7));
+        std::vector<T> reRef(bins), imRef(bins);
+
+        reference(in.data(), size, table->getCos(0), table->getSin(0), table->getStride(),
+                  reRef.data(), imRef.data(), bins);
+        kernel(in.data(), size, table->getCos(0), table->getSin(0), table->getStride(), re.data(), im.data(), bins);
+
+        compare("dft re", level, bins, re.data(), reRef.data(), bins, scale);
+        compare("dft im", level, bins, im.data(), imRef.data(), bins, scale);
+
+        if (re[bins] != T(7) || im[bins] != T(7)) {
+            ++failures;
+            std::printf("FAIL dft    %-6s %-6s shape %4d  wrote past bins\n", typeName<T>(),
+                        SimdKernels::getName(level), bins);
+        }
+    }
+}
+
+template <typename T>
+static void checkAxpy(const SimdKernels::Level level, std::mt19937& random) {
+    const SimdKernels::AxpyKernel<T> reference = SimdKernels::getAxpyKernel<T>(SimdKernels::SCALAR);
+    const SimdKernels::AxpyKernel<T> kernel = SimdKernels::getAxpyKernel<T>(level);
+    std::uniform_real_distribution<double> uniform(-1., 1.);
+
+    for (int count = 0; count <= 67; ++count) {
+        const T a = static_cast<T>(uniform(random));
+        std::vector<T> x(count + 1), y(count + 1);
+        for (int i = 0; i <= count; ++i) {
+            x[i] = static_cast<T>(uniform(random));
+            y[i] = static_cast<T>(uniform(random));
+        }
+        std::vector<T> yRef(y);
+
+        reference(a, x.data(), yRef.data(), count);
+        kernel(a, x.data(), y.data(), count);
+
+        // includes the spare value, which must be left alone
+        compare("axpy", level, count, y.data(), yRef.data(), count + 1, T(1));
+    }
+}
+
+template <typename T>
+static void checkBiquad(const SimdKernels::Level level, std::mt19937& random) {
+    const SimdKernels::BiquadKernel<T> reference = SimdKernels::getBiquadKernel<T>(SimdKernels::SCALAR);
+    const SimdKernels::BiquadKernel<T> kernel = SimdKernels::getBiquadKernel<T>(level);
+    std::uniform_real_distribution<double> uniform(-1., 1.);
+
+    // stable low pass section, {b0, b1, b2, a1, a2}
+    const T coefficients[5] = {T(0.0675), T(0.135), T(0.0675), T(-1.143), T(0.4128)};
+    const int frames = CHECK_SAMPLES;
+
+    for (const int channels : {1, 3, 4, 5, 8, 9, 16, 17, NUM_BRAIN_SITES, 32, 33}) {
+        std::vector<T> data(frames * channels);
+        for (T& x : data)
+            x = static_cast<T>(uniform(random));
+        std::vector<T> dataRef(data);
+
+        std::vector<T> z1(channels), z2(channels);
+        for (int c = 0; c < channels; ++c) {
+            z1[c] = static_cast<T>(uniform(random));
+            z2[c] = static_cast<T>(uniform(random));
+        }
+        std::vector<T> z1Ref(z1), z2Ref(z2);
+
+        reference(dataRef.data(), frames, channels, coefficients, z1Ref.data(), z2Ref.data());
+        kernel(data.data(), frames, channels, coefficients, z1.data(), z2.data());
+
+        // gain around 1, the recursion can double the rounding error over the block
+        compare("biquad", level, channels, data.data(), dataRef.data(), frames * channels, T(4));
+        compare("z1", level, channels, z1.data(), z1Ref.data(), channels, T(4));
+        compare("z2", level, channels, z2.data(), z2Ref.data(), channels, T(4));
+    }
+}
+
+template <typename T>
+static void checkLevel(const SimdKernels::Level level) {
+    std::mt19937 random(2024);
+    checkDft<T>(level, random);
+    checkAxpy<T>(level, random);
+    checkBiquad<T>(level, random);
+}
+
+
+int main() {
+    const SimdKernels::Level available = SimdKernels::getLevel();
+    std::printf("SIMD: %s\n", SimdKernels::getName(available));
+
+    // levels above what the CPU reports would fault, they are skipped
+    for (const SimdKernels::Level level : {SimdKernels::SCALAR, SimdKernels::AVX2, SimdKernels::AVX512}) {
+        if (level > available) {
+            std::printf("skip %s, not supported here\n", SimdKernels::getName(level));
+            continue;
+        }
+
+        checkLevel<double>(level);
+        checkLevel<float>(level);
+        std::printf("checked %s\n", SimdKernels::getName(level));
+    }
+
+    std::printf(failures ? "%d FAILED\n" : "all passed\n", failures);
+    return failures;
+}
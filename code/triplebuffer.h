@@ -0,0 +1,59 @@
+#ifndef TRIPLEBUFFER_H
+#define TRIPLEBUFFER_H
+
+#include <atomic>
+
+// set on the shared index when it holds a snapshot the reader has not taken yet
+#define TRIPLE_FRESH 4
+#define TRIPLE_INDEX 3
+
+
+/*
+    Wait free hand over of the latest value from one producer to one consumer.
+
+    Three slots: the producer owns back, the consumer owns front, middle is swapped atomically.
+
+        write()     back slot, fill it in place
+        publish()   back <-> middle, marked fresh
+        read()      if fresh, front <-> middle; the newest complete value either way
+
+    Neither side ever waits or sees a partial write. A consumer slower than the producer skips
+    to the newest value, one faster keeps the last one. Several producers are fine as long as
+    something else serializes them.
+
+    Slots are copies of initial, so vectors keep their sizes and filling them never allocates.
+*/
+template <typename T>
+class TripleBuffer {
+    private:
+        T slots[3];
+        alignas(64) std::atomic<int> middle;
+        alignas(64) int back;   // producer
+        alignas(64) int front;  // consumer
+
+    public:
+        TripleBuffer() : middle(1), back(0), front(2) {}
+
+        explicit TripleBuffer(const T& initial) : slots{initial, initial, initial}, middle(1), back(0), front(2) {}
+
+        T& write() {
+            return slots[back];
+        }
+
+        void publish() {
+            back = middle.exchange(back | TRIPLE_FRESH, std::memory_order_acq_rel) & TRIPLE_INDEX;
+        }
+
+        const T& read() {
+            if (middle.load(std::memory_order_relaxed) & TRIPLE_FRESH)
+                front = middle.exchange(front, std::memory_order_acq_rel) & TRIPLE_INDEX;
+
+            return slots[front];
+        }
+
+        // a publish the consumer has not read yet
+        bool isFresh() const {
+            return middle.load(std::memory_order_acquire) & TRIPLE_FRESH;
+        }
+};
+#endif
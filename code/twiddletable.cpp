@@ -0,0 +1,197 @@
+#include "twiddletable.h"
+
+#include <iterator>
+#include <new>
+
+
+// first TWIDDLE_ALIGN boundary in ptr, allocations carry TWIDDLE_ALIGN spare bytes
+static char* alignBlock(char* ptr) {
+    const std::size_t offset = reinterpret_cast<std::uintptr_t>(ptr) % TWIDDLE_ALIGN;
+    return offset ? ptr + TWIDDLE_ALIGN - offset : ptr;
+}
+
+// entries whose table every user released, lock held
+template <typename Cache>
+static void prune(Cache& cache) {
+    for (auto it = cache.begin(); it != cache.end();)
+        it = it->second.expired() ? cache.erase(it) : std::next(it);
+}
+
+
+template <typename T>
+std::mutex TwiddleTable<T>::cacheMtx;
+
+template <typename T>
+std::map<std::tuple<int, int, int>, std::weak_ptr<const TwiddleTable<T>>> TwiddleTable<T>::cache;
+
+
+template <typename T>
+TwiddleTable<T>::TwiddleTable(const int size, const int length, const int bins) :
+        size(size), length(length), bins(bins),
+        stride((bins + TWIDDLE_ALIGN / sizeof(T) - 1) / (TWIDDLE_ALIGN / sizeof(T)) * (TWIDDLE_ALIGN / sizeof(T))),
+        raw(new char[2 * size * stride * sizeof(T) + TWIDDLE_ALIGN]()),
+        block(align(raw)),
+        cosine(block), sine(block + size * stride) {
+    build();
+}
+
+template <typename T>
+TwiddleTable<T>::~TwiddleTable() {
+    delete[] raw;
+}
+
+
+template <typename T>
+T* TwiddleTable<T>::align(char* ptr) const {
+    return reinterpret_cast<T*>(alignBlock(ptr));
+}
+
+
+/*
+    Fill the coefficients.
+
+    k * n mod length indexes one period of cos and sin, looked up from DspTables for the
+    default rate, otherwise length trig calls.
+*/
+template <typename T>
+void TwiddleTable<T>::build() {
+    double* const period = new double[2 * length];
+
+    for (int m = 0; m < length; ++m) {
+        const std::complex<double> unit = DspTables::phasor(length, m);
+        period[m] = unit.real();
+        period[length + m] = -unit.imag();
+    }
+
+    for (int n = 0; n < size; ++n) {
+        T* const cosRow = block + n * stride;
+        T* const sinRow = block + (size + n) * stride;
+
+        for (int k = 0, m = 0; k < bins; ++k, m = (m + n) % length) {
+            cosRow[k] = static_cast<T>(period[m]);
+            sinRow[k] = static_cast<T>(period[length + m]);
+        }
+    }
+
+    delete[] period;
+}
+
+
+/*
+    Shared table for a shape, built lazily.
+
+    A new sample rate builds a new table, the old one is freed once no engine holds it and its
+    entry is dropped on a later lookup.
+*/
+template <typename T>
+std::shared_ptr<const TwiddleTable<T>> TwiddleTable<T>::get(const int size, const int length, const int bins) {
+    std::lock_guard<std::mutex> lock(cacheMtx);
+    prune(cache);
+
+    const std::tuple<int, int, int> key(size, length, bins);
+    std::shared_ptr<const TwiddleTable<T>> table = cache[key].lock();
+
+    if (!table) {
+        table = std::shared_ptr<const TwiddleTable<T>>(new TwiddleTable<T>(size, length, bins));
+        cache[key] = table;
+    }
+
+    return table;
+}
+
+
+// row n, cos(2 pi k n / length) for k in [0, bins)
+template <typename T>
+const T* TwiddleTable<T>::getCos(const int n) const {
+    return cosine + n * stride;
+}
+
+// row n, -sin(2 pi k n / length) for k in [0, bins)
+template <typename T>
+const T* TwiddleTable<T>::getSin(const int n) const {
+    return sine + n * stride;
+}
+
+template <typename T>
+int TwiddleTable<T>::getSize() const {
+    return size;
+}
+
+template <typename T>
+int TwiddleTable<T>::getLength() const {
+    return length;
+}
+
+template <typename T>
+int TwiddleTable<T>::getBins() const {
+    return bins;
+}
+
+template <typename T>
+int TwiddleTable<T>::getStride() const {
+    return stride;
+}
+
+
+template class TwiddleTable<float>;
+template class TwiddleTable<double>;
+
+
+//--------------------------------------------------------------------------------------//
+// fft phasors
+
+template <typename T>
+std::mutex PhasorTable<T>::cacheMtx;
+
+template <typename T>
+std::map<int, std::weak_ptr<const PhasorTable<T>>> PhasorTable<T>::cache;
+
+
+template <typename T>
+PhasorTable<T>::PhasorTable(const int length) :
+        length(length),
+        raw(new char[length * sizeof(std::complex<T>) + TWIDDLE_ALIGN]),
+        phasors(reinterpret_cast<std::complex<T>*>(alignBlock(raw))) {
+    for (int j = 0; j < length; ++j)
+        new (phasors + j) std::complex<T>(std::conj(DspTables::phasor(length, j)));
+}
+
+template <typename T>
+PhasorTable<T>::~PhasorTable() {
+    delete[] raw;
+}
+
+
+/*
+    Shared table for a length, built lazily, released with its last user.
+*/
+template <typename T>
+std::shared_ptr<const PhasorTable<T>> PhasorTable<T>::get(const int length) {
+    std::lock_guard<std::mutex> lock(cacheMtx);
+    prune(cache);
+
+    std::shared_ptr<const PhasorTable<T>> table = cache[length].lock();
+
+    if (!table) {
+        table = std::shared_ptr<const PhasorTable<T>>(new PhasorTable<T>(length));
+        cache[length] = table;
+    }
+
+    return table;
+}
+
+
+// e^(-2 pi i j / length), j in [0, length)
+template <typename T>
+const std::complex<T>* PhasorTable<T>::getPhasors() const {
+    return phasors;
+}
+
+template <typename T>
+int PhasorTable<T>::getLength() const {
+    return length;
+}
+
+
+template class PhasorTable<float>;
+template class PhasorTable<double>;
@@ -0,0 +1,89 @@
+#ifndef TWIDDLETABLE_H
+#define TWIDDLETABLE_H
+
+#include <cmath>
+#include <complex>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <tuple>
+
+#include "defs.h"
+#include "dsptables.h"
+
+#define TWIDDLE_ALIGN 64 // bytes, one cache line
+
+
+/*
+    Ready to multiply partial DFT coefficients.
+
+    One aligned block: size rows of cos(2 pi k n / length), then size rows of -sin(...).
+    Rows are padded to stride so every row starts on a cache line.
+
+    Shared, built on first request for a (size, length, bins) shape and released with the last user.
+    One cache per sample type.
+*/
+template <typename T>
+class TwiddleTable {
+    private:
+        const int size;
+        const int length;
+        const int bins;
+        const int stride;
+
+        char* const raw;       // unaligned allocation
+        T* const block;        // aligned view into raw
+        const T* const cosine;
+        const T* const sine;
+
+        static std::mutex cacheMtx;
+        static std::map<std::tuple<int, int, int>, std::weak_ptr<const TwiddleTable<T>>> cache;
+
+        TwiddleTable(const int size, const int length, const int bins);
+        T* align(char* ptr) const;
+        void build();
+
+    public:
+        ~TwiddleTable();
+
+        static std::shared_ptr<const TwiddleTable<T>> get(const int size, const int length, const int bins);
+
+        const T* getCos(const int n) const;
+        const T* getSin(const int n) const;
+
+        int getSize() const;
+        int getLength() const;
+        int getBins() const;
+        int getStride() const;
+};
+
+
+/*
+    FFT twiddles e^(-2 pi i j / length) for j in [0, length), one aligned block.
+
+    Shared per length and built on first request like TwiddleTable, so every ComplexFFT of a
+    length (multitaper engines, batch workers) reads the same copy.
+*/
+template <typename T>
+class PhasorTable {
+    private:
+        const int length;
+
+        char* const raw;                // unaligned allocation
+        std::complex<T>* const phasors; // aligned view into raw
+
+        static std::mutex cacheMtx;
+        static std::map<int, std::weak_ptr<const PhasorTable<T>>> cache;
+
+        explicit PhasorTable(const int length);
+
+    public:
+        ~PhasorTable();
+
+        static std::shared_ptr<const PhasorTable<T>> get(const int length);
+
+        const std::complex<T>* getPhasors() const;
+        int getLength() const;
+};
+#endif
@@ -0,0 +1,103 @@
+#include "wavesynth.h"
+
+
+WaveSynth::WaveSynth(const int rate, const std::vector<WaveBand>& bands, const uint64_t seed, const double step) :
+        rate(rate), bands(bands), step(step), seed(seed), noiseType(NoiseGenerator::UNIFORM), noiseAmp(0.) {}
+
+
+/*
+    One site: background (or silence), then every band accumulated on top.
+*/
+template <typename T>
+void WaveSynth::site(NoiseGenerator& random, const int index, T* out, const int samples) const {
+    const int count = static_cast<int>(bands.size());
+    std::vector<double> draws(2 * count);
+    random.fill<double>(NoiseGenerator::UNIFORM, index, draws.data(), 2 * count, 1.);
+
+    if (noiseAmp > 0.)
+        random.fill(noiseType, index, out, samples, noiseAmp);
+    else
+        std::fill(out, out + samples, T(0));
+
+    std::vector<Oscillator> tones;
+    std::vector<double> amps;
+    for (int b = 0; b < count; ++b) {
+        const WaveBand& band = bands[b];
+
+        double freq = band.center + band.offset * draws[2 * b];
+        if (step > 0.)
+            freq = std::round(freq / step) * step;
+        freq = std::min(std::max(freq, 0.), rate / 2.);
+
+        tones.emplace_back(freq, rate);
+        amps.push_back(band.amp + band.spread * draws[2 * b + 1]);
+    }
+
+    // long rows in tiles, every band is added while the tile is still in L1
+    for (int first = 0; first < samples; first += WAVESYNTH_TILE) {
+        const int length = std::min(WAVESYNTH_TILE, samples - first);
+        for (int b = 0; b < count; ++b)
+            tones[b].accumulate(out + first, length, amps[b]);
+    }
+}
+
+
+/*
+    One site per row, a sample per column. Small montages stay on the calling thread.
+*/
+template <typename T>
+void WaveSynth::generate(const MatrixView<T> out) const {
+    const int sites = out.rows;
+    const int samples = out.cols;
+    if (sites <= 0 || samples <= 0)
+        return;
+
+    NoiseGenerator random(sites, seed);
+    const int grain = std::max(1, WAVESYNTH_GRAIN / samples);
+
+    parallelFor(0, sites, grain, [&](const int first, const int last) {
+        for (int s = first; s < last; ++s)
+            site(random, s, out[s], samples);
+    });
+}
+
+
+/*
+    Background noise under the tones, amplitude 0 disables it.
+*/
+void WaveSynth::setNoise(const NoiseGenerator::Type type, const double amplitude) {
+    noiseType = type;
+    noiseAmp = amplitude;
+}
+
+void WaveSynth::setSeed(const uint64_t seed) {
+    this->seed = seed;
+}
+
+int WaveSynth::getRate() const {
+    return rate;
+}
+
+const std::vector<WaveBand>& WaveSynth::getBands() const {
+    return bands;
+}
+
+
+/*
+    delta, theta, alpha, beta as the device expects them, see defs.h.
+*/
+std::vector<WaveBand> WaveSynth::defaultBands() {
+    const double centers[NUM_BRAIN_FREQ] = BAND_CENTERS;
+    const double offsets[NUM_BRAIN_FREQ] = BAND_OFFSETS;
+    const double amps[NUM_BRAIN_FREQ] = BAND_AMPS;
+
+    std::vector<WaveBand> mix;
+    for (int i = 0; i < NUM_BRAIN_FREQ; ++i)
+        mix.push_back({centers[i], offsets[i], amps[i], BAND_AMP_SPREAD});
+
+    return mix;
+}
+
+
+template void WaveSynth::generate<float>(const MatrixView<float> out) const;
+template void WaveSynth::generate<double>(const MatrixView<double> out) const;
@@ -0,0 +1,71 @@
+#ifndef WAVESYNTH_H
+#define WAVESYNTH_H
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+#include "defs.h"
+#include "matrix.h"
+#include "noisegenerator.h"
+#include "oscillator.h"
+#include "parallel.h"
+
+// samples of work per thread before synthesis is split across cores
+#define WAVESYNTH_GRAIN 65536
+// samples per row tile, bands accumulate into one tile at a time
+#define WAVESYNTH_TILE 2048
+
+
+/*
+    One component of a band mix. Per site the tone is drawn as
+        freq    center +- offset, rounded to the synth's frequency step
+        amp     amp +- spread
+*/
+struct WaveBand {
+    double center; // hz
+    double offset; // hz
+    double amp;    // uv
+    double spread; // uv
+};
+
+
+/*
+    Synthetic montage generator, any number of sites, samples and bands.
+
+    Every site draws its band frequencies and amplitudes (and optional background noise) from its
+    own NoiseGenerator stream, so the output depends only on the seed and never on the thread
+    split. Tones come from Oscillator, sites run in parallel through parallelFor.
+
+    Frequencies are quantized to step (0.5 hz by default) so the zero padded DFT lands on exact
+    bins, step 0 keeps them continuous.
+*/
+class WaveSynth {
+    private:
+        const int rate;
+        std::vector<WaveBand> bands;
+        double step;
+        uint64_t seed;
+
+        NoiseGenerator::Type noiseType;
+        double noiseAmp;
+
+        template <typename T>
+        void site(NoiseGenerator& random, const int index, T* out, const int samples) const;
+
+    public:
+        WaveSynth(const int rate, const std::vector<WaveBand>& bands, const uint64_t seed, const double step = 0.5);
+
+        template <typename T>
+        void generate(const MatrixView<T> out) const;
+
+        void setNoise(const NoiseGenerator::Type type, const double amplitude);
+        void setSeed(const uint64_t seed);
+
+        int getRate() const;
+        const std::vector<WaveBand>& getBands() const;
+
+        static std::vector<WaveBand> defaultBands();
+};
+#endif
@@ -0,0 +1,149 @@
+#include "welchpsd.h"
+
+
+template <typename T>
+WelchPSD<T>::WelchPSD(const Window::Type type, const int rate, const int segment, const int overlap,
+                      const int length, const int bins, const int average) :
+        rate(rate), segment(segment), hop(std::max(1, segment - std::max(0, overlap))),
+        bins(bins), average(std::max(1, average)),
+        window(new T[segment]()), scale(0.),
+        engine(SpectralEngine<T>::create(segment, length, bins)),
+        history(new T[segment]()), tapered(new T[segment]()),
+        re(new T[bins]()), im(new T[bins]()),
+        position(0), untilNext(segment),
+        segments(new double[this->average * bins]()), sum(new double[bins]()), psd(new double[bins]()),
+        head(0), count(0) {
+
+    Window::fill(type, window, segment);
+
+    double power = 0.;
+    for (int i = 0; i < segment; ++i)
+        power += static_cast<double>(window[i]) * window[i];
+
+    scale = 1. / (rate * power);
+}
+
+template <typename T>
+WelchPSD<T>::~WelchPSD() {
+    delete engine;
+    delete[] window;
+    delete[] history;
+    delete[] tapered;
+    delete[] re;
+    delete[] im;
+    delete[] segments;
+    delete[] sum;
+    delete[] psd;
+}
+
+
+/*
+    New samples, oldest first. Segments are processed as soon as they complete.
+*/
+template <typename T>
+void WelchPSD<T>::push(const T* samples, const int count) {
+    for (int i = 0; i < count; ++i) {
+        history[position] = samples[i];
+        position = (position + 1) % segment;
+
+        if (--untilNext == 0) {
+            process();
+            untilNext = hop;
+        }
+    }
+}
+
+
+/*
+    Taper, transform and fold the latest segment into the running mean.
+*/
+template <typename T>
+void WelchPSD<T>::process() {
+    // position is the oldest sample once the ring is full
+    for (int i = 0; i < segment; ++i)
+        tapered[i] = history[(position + i) % segment] * window[i];
+
+    engine->transform(tapered, re, im);
+
+    const int length = engine->getLength();
+    double* const latest = segments + head * bins;
+
+    for (int k = 0; k < bins; ++k) {
+        double power = (static_cast<double>(re[k]) * re[k] + static_cast<double>(im[k]) * im[k]) * scale;
+
+        // one sided, dc and nyquist appear once
+        if (k > 0 && 2 * k != length)
+            power *= 2.;
+
+        sum[k] += power - latest[k];
+        latest[k] = power;
+    }
+
+    head = (head + 1) % average;
+    count = std::min(count + 1, average);
+
+    // running sum is rebuilt once per lap to stop rounding drift
+    if (head == 0)
+        for (int k = 0; k < bins; ++k) {
+            sum[k] = 0.;
+            for (int s = 0; s < average; ++s)
+                sum[k] += segments[s * bins + k];
+        }
+
+    for (int k = 0; k < bins; ++k)
+        psd[k] = sum[k] / count;
+}
+
+
+/*
+    Next push starts a new segment, the average is kept. For input that does not follow on from
+    the last push (a regenerated window), no segment then spans the discontinuity.
+*/
+template <typename T>
+void WelchPSD<T>::restart() {
+    position = 0;
+    untilNext = segment;
+}
+
+
+/*
+    Drops history and the average.
+*/
+template <typename T>
+void WelchPSD<T>::reset() {
+    for (int i = 0; i < segment; ++i)
+        history[i] = 0;
+    for (int i = 0; i < average * bins; ++i)
+        segments[i] = 0.;
+    for (int k = 0; k < bins; ++k) {
+        sum[k] = 0.;
+        psd[k] = 0.;
+    }
+
+    position = 0;
+    untilNext = segment;
+    head = 0;
+    count = 0;
+}
+
+
+// averaged density per bin
+template <typename T>
+const double* WelchPSD<T>::getPSD() const {
+    return psd;
+}
+
+template <typename T>
+int WelchPSD<T>::getBins() const {
+    return bins;
+}
+
+// segments in the current average
+template <typename T>
+int WelchPSD<T>::getSegments() const {
+    return count;
+}
+
+
+template class WelchPSD<float>;
+template class WelchPSD<double>;
@@ -0,0 +1,61 @@
+#ifndef WELCHPSD_H
+#define WELCHPSD_H
+
+#include <algorithm>
+
+#include "defs.h"
+#include "spectralengine.h"
+#include "window.h"
+
+
+/*
+    Welch power spectral density, kept live as samples arrive.
+
+    Every hop = segment - overlap new samples the latest segment is tapered, transformed
+    (zero padded to length) and its one sided PSD replaces the oldest of the last average
+    segments. The mean is kept as a running sum, so each segment costs one transform plus O(bins).
+
+    Units are input^2 / Hz (uV^2 / Hz for the device).
+*/
+template <typename T>
+class WelchPSD {
+    private:
+        const int rate;
+        const int segment;
+        const int hop;
+        const int bins;
+        const int average;
+
+        T* const window;                // precomputed taper
+        double scale;                   // 1 / (rate * sum w^2)
+
+        SpectralEngine<T>* const engine;
+        T* const history;               // last segment samples, ring
+        T* const tapered;
+        T* const re;
+        T* const im;
+        int position;                   // next write in history
+        int untilNext;                  // samples before the next segment
+
+        double* const segments;         // average x bins, ring of segment PSDs
+        double* const sum;
+        double* const psd;
+        int head;
+        int count;
+
+        void process();
+
+    public:
+        WelchPSD(const Window::Type type, const int rate, const int segment, const int overlap,
+                 const int length, const int bins, const int average);
+        ~WelchPSD();
+
+        void push(const T* samples, const int count);
+        void restart();
+        void reset();
+
+        const double* getPSD() const;
+        int getBins() const;
+        int getSegments() const;
+};
+#endif
@@ -0,0 +1,32 @@
+#include "window.h"
+
+
+template <typename T>
+void Window::fill(const Type type, T* out, const int n) {
+    for (int i = 0; i < n; ++i) {
+        const double phase = 2. * PI * i / n;
+        double w = 1.;
+
+        switch (type) {
+            case HANN: w = 0.5 - 0.5 * std::cos(phase); break;
+            case HAMMING: w = 0.54 - 0.46 * std::cos(phase); break;
+            case BLACKMAN: w = 0.42 - 0.5 * std::cos(phase) + 0.08 * std::cos(2. * phase); break;
+            default: break;
+        }
+
+        out[i] = static_cast<T>(w);
+    }
+}
+
+template void Window::fill<float>(const Type type, float* out, const int n);
+template void Window::fill<double>(const Type type, double* out, const int n);
+
+
+const char* Window::getName(const Type type) {
+    switch (type) {
+        case HANN: return "hann";
+        case HAMMING: return "hamming";
+        case BLACKMAN: return "blackman";
+        default: return "rectangular";
+    }
+}
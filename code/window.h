@@ -0,0 +1,23 @@
+#ifndef WINDOW_H
+#define WINDOW_H
+
+#include <cmath>
+
+#include "defs.h"
+
+
+/*
+    Segment tapers for spectral estimation.
+
+    Periodic form (length n, period n), as used for overlapped FFT segments.
+*/
+class Window {
+    public:
+        enum Type { RECTANGULAR, HANN, HAMMING, BLACKMAN };
+
+        template <typename T>
+        static void fill(const Type type, T* out, const int n);
+
+        static const char* getName(const Type type);
+};
+#endif